@@ -0,0 +1,176 @@
+#pragma once
+
+#include "audio_engine/spsc_queue.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+#include <variant>
+
+namespace bit
+{
+// Object the audio thread stopped using, handed back to be destroyed on the
+// thread that created it.
+struct retired
+{
+    void* object           = nullptr;
+    void (*destroy)(void*) = nullptr;
+
+    void release() const
+    {
+        if (destroy)
+        {
+            destroy(object);
+        }
+    }
+};
+
+template <typename T> [[nodiscard]] retired retire(T* object) noexcept
+{
+    return {object, [](void* pointer) { delete static_cast<T*>(pointer); }};
+}
+
+// Two way channel between the control thread (UI, QML, MIDI) and the render
+// thread. Commands are fixed size trivially copyable messages, copied into a
+// wait-free queue, so sending never blocks the UI on the audio thread or the
+// other way around. The return queue carries what the render thread
+// replaced, e.g. the old table after a pointer swap, to be freed later by
+// collect() on the control thread.
+//
+// dispatch() and retire() are the only calls on the render path; they don't
+// allocate and don't lock.
+template <typename CommandT, typename ReturnT = retired>
+    requires(std::is_trivially_copyable_v<CommandT> and
+             std::is_trivially_copyable_v<ReturnT>)
+class command_queue
+{
+  public:
+    using command_type = CommandT;
+    using return_type  = ReturnT;
+
+  private:
+    spsc_queue<CommandT> _commands;
+    spsc_queue<ReturnT> _returns;
+
+  public:
+    explicit command_queue(size_t capacity,
+                           std::pmr::memory_resource* resource =
+                               std::pmr::get_default_resource())
+        : _commands{capacity, resource}, _returns{capacity, resource}
+    {
+    }
+
+    // control thread, false when the render thread fell behind
+    [[nodiscard]] bool send(const CommandT& command) noexcept
+    {
+        return _commands.push(command);
+    }
+
+    // control thread, hands every returned object to handler
+    template <std::invocable<const ReturnT&> HandlerT>
+    size_t collect(HandlerT&& handler)
+    {
+        size_t collected = 0;
+        while (auto returned = _returns.pop())
+        {
+            handler(*returned);
+            ++collected;
+        }
+        return collected;
+    }
+
+    // control thread, destroys every retired object
+    size_t collect()
+        requires std::same_as<ReturnT, retired>
+    {
+        return collect([](const retired& object) { object.release(); });
+    }
+
+    // commands not dispatched yet
+    [[nodiscard]] size_t pending() const noexcept
+    {
+        return _commands.size();
+    }
+
+    // render thread, applies the commands sent so far in order; the ones
+    // sent meanwhile wait for the next block
+    template <std::invocable<const CommandT&> HandlerT>
+    size_t dispatch(HandlerT&& handler) noexcept
+    {
+        auto pending = _commands.size();
+        for (size_t i = 0; i < pending; ++i)
+        {
+            handler(*_commands.pop());
+        }
+        return pending;
+    }
+
+    // render thread, false when the control thread doesn't collect
+    [[nodiscard]] bool retire(const ReturnT& object) noexcept
+    {
+        return _returns.push(object);
+    }
+};
+
+struct stored_patch;
+
+namespace commands
+{
+struct set_bit_depth
+{
+    uint8_t depth;
+};
+
+struct set_frequency
+{
+    float hertz;
+};
+
+// master gain of the synth, smoothed over the patch's smoothing time
+struct set_gain
+{
+    float gain;
+};
+
+// of the synth's low pass, smoothed like the gain
+struct set_cutoff
+{
+    float hertz;
+};
+
+// plays the patch from the next note on, e.g. one of a patch_bank, which
+// has to outlive its use
+struct set_program
+{
+    const stored_patch* patch;
+};
+
+struct set_device
+{
+    uint32_t index;
+};
+
+// replaces a shared object, e.g. a wavetable, by pointer; the old one goes
+// back through the return queue
+struct swap_object
+{
+    uint32_t slot;
+    void* object;
+    void (*destroy)(void*);
+};
+} // namespace commands
+
+using engine_command = std::variant<commands::set_bit_depth,
+                                    commands::set_frequency,
+                                    commands::set_gain,
+                                    commands::set_cutoff,
+                                    commands::set_program,
+                                    commands::set_device,
+                                    commands::swap_object>;
+
+static_assert(std::is_trivially_copyable_v<engine_command>);
+
+using engine_command_queue = command_queue<engine_command>;
+} // namespace bit
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bit
+{
+using node_id = uint32_t;
+
+// Processes one block of the given number of frames, e.g. a voice chain
+// writing its own buffer or an effect send reading the mix.
+using node_process = std::function<void(size_t frames)>;
+
+class graph_schedule;
+
+namespace detail
+{
+// one step of a busy wait; when it takes long the thread we wait for
+// probably shares our core, e.g. with more workers than cores, so let it run
+inline void backoff(size_t& spins) noexcept
+{
+    if (++spins > 1024)
+    {
+        std::this_thread::yield();
+    }
+}
+} // namespace detail
+
+// Nodes with explicit dependencies, built on the control thread whenever
+// the patch changes. compile() turns it into a graph_schedule, which is all
+// the render thread gets to see.
+class processing_graph
+{
+    std::vector<node_process> _nodes;
+    // pairs of (from, to)
+    std::vector<std::pair<node_id, node_id>> _edges;
+
+  public:
+    node_id add(node_process process);
+
+    // to has to run after from, in the same block
+    void connect(node_id from, node_id to);
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _nodes.size();
+    }
+
+    // throws std::runtime_error when the dependencies form a cycle
+    [[nodiscard]] std::unique_ptr<graph_schedule> compile() const;
+};
+
+// Topologically sorted graph with everything a block needs allocated up
+// front: dependency counters, the dependents of every node as one flat
+// array, and the slots of the ready queue. A schedule is run by one
+// graph_executor at a time.
+class graph_schedule
+{
+    friend class processing_graph;
+    friend class graph_executor;
+
+    static constexpr node_id none = ~node_id{0};
+
+    std::vector<node_process> _nodes;
+    // node ids in an order that respects every dependency
+    std::vector<node_id> _order;
+    // nodes without dependencies, in topological order
+    std::vector<node_id> _roots;
+    // dependents of node n are _dependents[_first[n]] to _first[n + 1]
+    std::vector<uint32_t> _first;
+    std::vector<node_id> _dependents;
+    std::vector<uint32_t> _dependencies;
+
+    // per block state
+    std::unique_ptr<std::atomic<uint32_t>[]> _remaining;
+    std::unique_ptr<std::atomic<node_id>[]> _ready;
+    // block number in the upper half, next ticket to claim in the lower
+    std::atomic<uint64_t> _head{0};
+    std::atomic<uint32_t> _tail{0};
+    std::atomic<uint32_t> _done{0};
+
+    graph_schedule() = default;
+
+    void reset(uint32_t block) noexcept;
+    // pushes node on the ready queue
+    void ready(node_id node) noexcept;
+    // runs ready nodes of block until all of them are claimed, returns
+    // right away when block is over
+    void drain(uint32_t block, size_t frames) noexcept;
+
+  public:
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return _nodes.size();
+    }
+
+    [[nodiscard]] const std::vector<node_id>& order() const noexcept
+    {
+        return _order;
+    }
+
+    // runs the whole block on the calling thread
+    void run(size_t frames) const;
+};
+} // namespace bit
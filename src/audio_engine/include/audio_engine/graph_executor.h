@@ -0,0 +1,55 @@
+#pragma once
+
+#include "audio_engine/graph.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace bit
+{
+// Pool of worker threads, each pinned to its own core, that run the
+// independent nodes of a graph_schedule in parallel with the render thread.
+// A block starts with the nodes without dependencies on the schedule's
+// ready queue; whoever finishes a node pushes the dependents it released,
+// and every thread keeps claiming from the queue until the block is done.
+//
+// run() neither allocates nor locks. Between blocks the workers spin for a
+// while and then sleep on an atomic wait, so a block after a pause pays for
+// waking them up.
+class graph_executor
+{
+    static constexpr size_t spin_limit = 1 << 16;
+
+    std::atomic<uint32_t> _block{0};
+    std::atomic<graph_schedule*> _schedule{nullptr};
+    std::atomic<size_t> _frames{0};
+    // workers that may still look at the schedule of the last block
+    std::atomic<size_t> _active{0};
+    std::atomic<bool> _stopping{false};
+    std::vector<std::jthread> _workers;
+
+    void work(size_t cpu) noexcept;
+
+  public:
+    // one worker per core apart from the one of the render thread
+    [[nodiscard]] static size_t default_workers() noexcept;
+
+    explicit graph_executor(size_t workers = default_workers());
+    ~graph_executor();
+
+    graph_executor(const graph_executor&)            = delete;
+    graph_executor& operator=(const graph_executor&) = delete;
+
+    [[nodiscard]] size_t workers() const noexcept
+    {
+        return _workers.size();
+    }
+
+    // render thread, returns when every node of the block has run, after
+    // which the schedule can be replaced and destroyed
+    void run(graph_schedule& schedule, size_t frames) noexcept;
+};
+} // namespace bit
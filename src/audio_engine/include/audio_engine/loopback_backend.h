@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace bit
+{
+enum class loopback_clock
+{
+    // virtual time, blocks are pulled back to back without sleeping
+    simulated,
+    // sleeps on the monotonic clock until every period starts
+    realtime,
+};
+
+struct loopback_settings
+{
+    double sampling_frequency = 48000;
+    size_t buffer_frames      = 256;
+    size_t channels           = 2;
+    loopback_clock clock      = loopback_clock::simulated;
+    // every callback starts up to this much after its period, uniformly
+    std::chrono::nanoseconds jitter{0};
+    uint64_t seed = 0;
+    // keeps all rendered samples, see captured()
+    bool capture = false;
+};
+
+// one callback, in nanoseconds since the first period started
+struct callback_timing
+{
+    int64_t scheduled;
+    int64_t started;
+    int64_t finished;
+    // the device needs the buffer by the start of the next period
+    int64_t deadline;
+
+    [[nodiscard]] int64_t processing() const noexcept
+    {
+        return finished - started;
+    }
+
+    // from the period start until the buffer was ready
+    [[nodiscard]] int64_t latency() const noexcept
+    {
+        return finished - scheduled;
+    }
+
+    [[nodiscard]] bool missed() const noexcept
+    {
+        return finished > deadline;
+    }
+};
+
+// Audio backend without a device: it pulls buffers from the render callback
+// on a fixed period the way a sound card would and records when every
+// callback ran, so latency and xruns can be measured on machines without
+// audio hardware.
+//
+// The simulated clock never sleeps: a callback starts at its period plus
+// the injected jitter, or when the one before it finished if that was
+// later, and lasts as long as the callback took on the steady clock. The
+// schedule and the jitter are reproducible from the seed, only the measured
+// processing times vary. The realtime clock sleeps until each period
+// instead, on clock_nanosleep with an absolute deadline on Linux, and
+// records the wake-up latency of the render thread too.
+//
+// run() allocates the records and the capture before the first callback
+// and nothing while running.
+class loopback_backend
+{
+  public:
+    // interleaved, buffer_frames * channels samples
+    using render_callback = std::function<void(std::span<int16_t>)>;
+
+  private:
+    loopback_settings _settings;
+    std::vector<int16_t> _buffer;
+    std::vector<int16_t> _captured;
+    std::vector<callback_timing> _timings;
+    size_t _misses = 0;
+
+    [[nodiscard]] int64_t period_start(size_t block) const noexcept;
+    [[nodiscard]] int64_t jitter(size_t block) const noexcept;
+
+  public:
+    explicit loopback_backend(const loopback_settings& settings);
+
+    [[nodiscard]] const loopback_settings& settings() const noexcept
+    {
+        return _settings;
+    }
+
+    // in nanoseconds, rounded
+    [[nodiscard]] int64_t period() const noexcept
+    {
+        return period_start(1);
+    }
+
+    // pulls blocks buffers from render on the calling thread, replacing the
+    // records of the previous run
+    void run(size_t blocks, const render_callback& render);
+
+    [[nodiscard]] std::span<const callback_timing> timings() const noexcept
+    {
+        return _timings;
+    }
+
+    [[nodiscard]] size_t deadline_misses() const noexcept
+    {
+        return _misses;
+    }
+
+    [[nodiscard]] std::span<const int16_t> captured() const noexcept
+    {
+        return _captured;
+    }
+};
+} // namespace bit
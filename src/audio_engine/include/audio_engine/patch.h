@@ -0,0 +1,74 @@
+#pragma once
+
+#include "dsp/polyblep.h"
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace bit
+{
+// sound of every voice, times in seconds
+struct patch
+{
+    dsp::waveform shape = dsp::waveform::saw;
+    double attack       = 0.005;
+    double decay        = 0.2;
+    double sustain      = 0.6;
+    double release      = 0.3;
+    // of the resonant low pass, in Hz
+    double cutoff    = 6000;
+    double resonance = 0.707;
+    // bits the crusher keeps and samples it holds
+    size_t depth = 16;
+    size_t hold  = 1;
+    // of a voice at full velocity, keep voices * gain below 1 for headroom
+    double gain = 0.25;
+    // a change of the master gain or the cutoff takes
+    double smoothing = 0.02;
+};
+
+// A patch the way a patch bank file lays it out and the synth plays it:
+// fixed size, little endian, every value already a qnumber, so it is used
+// in place with nothing to parse or convert. Fields are only ever added
+// together with a new bank version.
+struct stored_patch
+{
+    // zero padded, not terminated when all of it is used
+    std::array<char, 28> name;
+    // seconds
+    qu<8, 24> attack;
+    qu<8, 24> decay;
+    qu<8, 24> release;
+    qu<8, 24> smoothing;
+    qu<1, 31> sustain;
+    qu<1, 31> gain;
+    // Hz
+    qu<15, 17> cutoff;
+    qu<4, 28> resonance;
+    uint16_t hold;
+    // dsp::waveform
+    uint8_t shape;
+    uint8_t depth;
+
+    [[nodiscard]] std::string_view label() const noexcept
+    {
+        auto length = std::string_view{name.data(), name.size()}.find('\0');
+        return {name.data(), std::min(length, name.size())};
+    }
+};
+
+static_assert(sizeof(stored_patch) == 64);
+static_assert(std::is_trivially_copyable_v<stored_patch> and
+              std::is_standard_layout_v<stored_patch>);
+
+// clamps sustain, cutoff, depth and hold the way the synth does; throws
+// std::range_error when another value or the name doesn't fit its field
+[[nodiscard]] stored_patch to_stored_patch(const patch& sound,
+                                           std::string_view name = {});
+[[nodiscard]] patch to_patch(const stored_patch& stored) noexcept;
+} // namespace bit
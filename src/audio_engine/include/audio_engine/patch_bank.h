@@ -0,0 +1,98 @@
+#pragma once
+
+#include "audio_engine/patch.h"
+#include "io/mapped_file.h"
+#include "math/qnumber.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace bit
+{
+// first bytes of a patch bank file
+struct patch_bank_header
+{
+    std::array<char, 4> magic;
+    uint16_t version;
+    // sizeof(stored_patch) of the version
+    uint16_t patch_size;
+    uint32_t patches;
+    uint32_t tables;
+    // samples of every table
+    uint32_t table_length;
+    uint32_t reserved;
+    // of everything after the header
+    uint64_t checksum;
+};
+
+static_assert(sizeof(patch_bank_header) == 32);
+
+// Patches and wavetables in one binary file that is used straight from a
+// memory map: the header, the patches, then the tables, each a run of
+// qs<0, 15> samples of the same length. Everything is little endian and
+// naturally aligned. Loading checks the header, the checksum and the
+// patches once and parses nothing; after that a program change is a
+// pointer into the map, e.g. handed to the synth by commands::set_program.
+class patch_bank
+{
+  public:
+    using table_sample = qs<0, 15>;
+
+    static constexpr std::array<char, 4> magic{'B', 'C', 'P', 'B'};
+    static constexpr uint16_t version = 1;
+
+  private:
+    std::optional<io::mapped_file> _file;
+    std::span<const stored_patch> _patches;
+    std::span<const table_sample> _tables;
+    size_t _table_length = 0;
+
+    void load(std::span<const uint8_t> bytes);
+
+  public:
+    // maps the file; both throw std::runtime_error on anything but a valid
+    // bank of this version
+    explicit patch_bank(const std::filesystem::path& path);
+    // borrows bytes aligned to 8, which must outlive the bank
+    explicit patch_bank(std::span<const uint8_t> bytes);
+
+    [[nodiscard]] std::span<const stored_patch> patches() const noexcept
+    {
+        return _patches;
+    }
+
+    [[nodiscard]] const stored_patch& patch(size_t index) const noexcept
+    {
+        return _patches[index];
+    }
+
+    // the first patch named so, nullptr when there is none
+    [[nodiscard]] const stored_patch* find(
+        std::string_view name) const noexcept;
+
+    [[nodiscard]] size_t tables() const noexcept
+    {
+        return _table_length == 0 ? 0 : _tables.size() / _table_length;
+    }
+
+    [[nodiscard]] std::span<const table_sample> table(
+        size_t index) const noexcept
+    {
+        return _tables.subspan(index * _table_length, _table_length);
+    }
+};
+
+// The bytes of a bank file holding the patches and the tables, which are
+// table_length samples each; written as is, the file loads into a
+// patch_bank.
+[[nodiscard]] std::vector<uint8_t> pack_patch_bank(
+    std::span<const stored_patch> patches,
+    std::span<const patch_bank::table_sample> tables = {},
+    size_t table_length                              = 0);
+} // namespace bit
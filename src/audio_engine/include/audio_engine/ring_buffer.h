@@ -1,15 +1,63 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <cstddef>
 #include <exception>
 #include <memory_resource>
 #include <ranges>
+#include <span>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
 namespace bit
 {
-template <typename T> class ring_buffer
+// How a ring_buffer maps its ever growing indices onto the storage.
+// any_capacity takes every capacity and pays a division per access;
+// power_of_two_capacity only takes powers of two and masks instead.
+struct any_capacity
+{
+    [[nodiscard]] static constexpr bool accepts(size_t) noexcept
+    {
+        return true;
+    }
+
+    [[nodiscard]] static constexpr size_t wrap(size_t index,
+                                               size_t capacity) noexcept
+    {
+        return index % capacity;
+    }
+};
+
+struct power_of_two_capacity
+{
+    [[nodiscard]] static constexpr bool accepts(size_t capacity) noexcept
+    {
+        return std::has_single_bit(capacity);
+    }
+
+    [[nodiscard]] static constexpr size_t wrap(size_t index,
+                                               size_t capacity) noexcept
+    {
+        return index & (capacity - 1);
+    }
+};
+
+template <typename T>
+concept capacity_policy = requires(size_t index, size_t capacity) {
+    { T::accepts(capacity) } -> std::same_as<bool>;
+    { T::wrap(index, capacity) } -> std::same_as<size_t>;
+};
+
+// Keeps the last capacity() values pushed, overwriting the oldest ones.
+// Iterators go from the oldest value to the newest; segments() hands out
+// the same values as at most two contiguous spans, for algorithms that are
+// faster on plain memory, e.g. std::ranges::copy becoming a memmove.
+template <typename T, capacity_policy CapacityPolicy = any_capacity>
+class ring_buffer
 {
   public:
     using value_type      = T;
@@ -33,18 +81,16 @@ template <typename T> class ring_buffer
             assert(_parent != nullptr);
         }
 
-        constexpr bool operator<=>(const iterator&) const noexcept = default;
+        constexpr auto operator<=>(const iterator&) const noexcept = default;
 
         constexpr reference operator*() noexcept
         {
-            assert(_parent->capacity() > 0);
-            return *(_parent->_start + (_index % _parent->capacity()));
+            return *_parent->slot(_index);
         }
 
         constexpr reference operator*() const noexcept
         {
-            assert(_parent->capacity() > 0);
-            return *(_parent->_start + (_index % _parent->capacity()));
+            return *_parent->slot(_index);
         }
 
         constexpr iterator& operator++() noexcept
@@ -59,14 +105,14 @@ template <typename T> class ring_buffer
             return *this;
         }
 
-        constexpr iterator operator++(int) const noexcept
+        constexpr iterator operator++(int) noexcept
         {
             auto tmp = *this;
             this->operator++();
             return tmp;
         }
 
-        constexpr iterator operator--(int) const noexcept
+        constexpr iterator operator--(int) noexcept
         {
             auto tmp = *this;
             this->operator--();
@@ -112,7 +158,7 @@ template <typename T> class ring_buffer
             return *tmp;
         }
 
-        constexpr reference operator[](difference_type) const noexcept
+        constexpr reference operator[](difference_type index) const noexcept
         {
             auto tmp = *this;
             tmp += index;
@@ -131,15 +177,15 @@ template <typename T> class ring_buffer
 
     struct const_iterator
     {
-        ring_buffer* _parent  = nullptr;
-        std::ptrdiff_t _index = 0;
+        const ring_buffer* _parent = nullptr;
+        std::ptrdiff_t _index      = 0;
 
         using difference_type = std::ptrdiff_t;
         using value_type      = typename ring_buffer::value_type;
         using const_reference = const value_type&;
 
         constexpr const_iterator() noexcept = default;
-        constexpr const_iterator(ring_buffer& parent,
+        constexpr const_iterator(const ring_buffer& parent,
                                  std::ptrdiff_t index = 0) noexcept
             : _parent(&parent), _index(index)
         {
@@ -150,19 +196,17 @@ template <typename T> class ring_buffer
         {
         }
 
-        constexpr bool operator<=>(const const_iterator&) const noexcept =
+        constexpr auto operator<=>(const const_iterator&) const noexcept =
             default;
 
         const_reference operator*() const noexcept
         {
-            assert(_parent->capacity() > 0);
-            return *(_parent->_start + (_index % _parent->capacity()));
+            return *_parent->slot(_index);
         }
 
         const_reference operator*() noexcept
         {
-            assert(_parent->capacity() > 0);
-            return *(_parent->_start + (_index % _parent->capacity()));
+            return *_parent->slot(_index);
         }
 
         const_iterator& operator++() noexcept
@@ -171,7 +215,7 @@ template <typename T> class ring_buffer
             return *this;
         }
 
-        const_iterator operator++(int) const noexcept
+        const_iterator operator++(int) noexcept
         {
             auto tmp = *this;
             this->operator++();
@@ -184,7 +228,7 @@ template <typename T> class ring_buffer
             return *this;
         }
 
-        const_iterator operator--(int) const noexcept
+        const_iterator operator--(int) noexcept
         {
             auto tmp = *this;
             this->operator--();
@@ -249,11 +293,31 @@ template <typename T> class ring_buffer
         std::pmr::get_default_resource();
     T* _start = nullptr;
     T* _end   = nullptr;
-    iterator _write_index{*this};
-    iterator _read_index{*this};
+    // of the oldest value, counting every value ever pushed
+    size_t _read{};
     size_t _size{};
     size_t _alignment{};
 
+    [[nodiscard]] constexpr T* slot(std::ptrdiff_t index) const noexcept
+    {
+        assert(capacity() > 0);
+        return _start +
+               CapacityPolicy::wrap(static_cast<size_t>(index), capacity());
+    }
+
+    // where the oldest value is and how many follow it before the end of
+    // the storage
+    [[nodiscard]] constexpr std::pair<size_t, size_t> segment_sizes()
+        const noexcept
+    {
+        if (_size == 0)
+        {
+            return {0, 0};
+        }
+        auto offset = CapacityPolicy::wrap(_read, capacity());
+        return {offset, std::min(_size, capacity() - offset)};
+    }
+
   public:
     ring_buffer() = default;
 
@@ -267,6 +331,10 @@ template <typename T> class ring_buffer
                          std::pmr::polymorphic_allocator<> allocator = {})
         : _allocator(allocator), _alignment(alignment)
     {
+        if (not CapacityPolicy::accepts(capacity))
+        {
+            throw std::range_error{"capacity not allowed by the policy"};
+        }
         auto allocation =
             _allocator.allocate_bytes(capacity * sizeof(T), _alignment);
         if (not allocation)
@@ -300,40 +368,86 @@ template <typename T> class ring_buffer
         return _size;
     }
 
+    // Only the last capacity() values can stay, so of a sized range only
+    // those are written, in at most two runs of std::ranges::copy_n.
+    // Neither way checks per value whether the buffer is full.
     template <std::ranges::forward_range R>
     constexpr void push(R&& values) noexcept
     {
-        for (const auto& v : values)
+        assert(capacity() > 0);
+        auto write = _read + _size;
+        size_t pushed{};
+        if constexpr (std::ranges::sized_range<R>)
         {
-            *_write_index = v;
-            ++_write_index;
-            if (_size == capacity())
+            pushed       = static_cast<size_t>(std::ranges::size(values));
+            auto skipped = pushed > capacity() ? pushed - capacity() : 0;
+            auto first   = std::ranges::next(
+                std::ranges::begin(values),
+                static_cast<std::ranges::range_difference_t<R>>(skipped));
+            write += skipped;
+            for (auto left = pushed - skipped; left > 0;)
             {
-                ++_read_index;
+                auto offset = CapacityPolicy::wrap(write, capacity());
+                auto run    = std::min(left, capacity() - offset);
+                first       = std::ranges::copy_n(
+                            first,
+                            static_cast<std::ranges::range_difference_t<R>>(
+                                run),
+                            _start + offset)
+                            .in;
+                write += run;
+                left -= run;
             }
-            _size = std::min(capacity(), _size + 1);
         }
+        else
+        {
+            for (const auto& v : values)
+            {
+                _start[CapacityPolicy::wrap(write++, capacity())] = v;
+                ++pushed;
+            }
+        }
+        _size = std::min(capacity(), _size + pushed);
+        _read = write - _size;
     }
 
     iterator begin() noexcept
     {
-        return _read_index;
+        return {*this, static_cast<std::ptrdiff_t>(_read)};
     }
 
     iterator end() noexcept
     {
-        return _read_index + _size;
+        return begin() + static_cast<std::ptrdiff_t>(_size);
     }
 
     [[nodiscard]] const_iterator begin() const noexcept
     {
-        return _read_index;
+        return {*this, static_cast<std::ptrdiff_t>(_read)};
     }
 
     [[nodiscard]] const_iterator end() const noexcept
     {
-        return _read_index + _size;
+        return begin() + static_cast<std::ptrdiff_t>(_size);
+    }
+
+    // the values from the oldest on, the second span empty unless they
+    // wrap around the end of the storage
+    [[nodiscard]] std::array<std::span<T>, 2> segments() noexcept
+    {
+        auto [offset, first] = segment_sizes();
+        return {std::span{_start + offset, first},
+                std::span{_start, _size - first}};
+    }
+
+    [[nodiscard]] std::array<std::span<const T>, 2> segments() const noexcept
+    {
+        auto [offset, first] = segment_sizes();
+        return {std::span<const T>{_start + offset, first},
+                std::span<const T>{_start, _size - first}};
     }
 };
 static_assert(std::ranges::range<ring_buffer<int>>);
+static_assert(
+    std::ranges::range<ring_buffer<int, power_of_two_capacity>>);
 } // namespace bit
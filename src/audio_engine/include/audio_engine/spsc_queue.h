@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+namespace bit
+{
+// Bounded wait-free queue for one producer and one consumer thread. Both
+// ends are a single atomic index each, owned by the side that writes it; the
+// other side's index is cached and reloaded only when the queue looks full
+// or empty, so in the common case push and pop touch no shared cache line
+// but their own. Capacity is rounded up to a power of two and indices wrap
+// with a mask.
+//
+// The storage is allocated once at construction, push() and pop() never
+// allocate, lock or loop.
+template <typename T>
+    requires(std::is_trivially_copyable_v<T> and
+             std::is_default_constructible_v<T>)
+class spsc_queue
+{
+  public:
+    using value_type = T;
+
+  private:
+    // a cache line on the platforms we build for, without the ABI warning
+    // of std::hardware_destructive_interference_size
+    static constexpr size_t line = 64;
+
+    static_assert(std::atomic<size_t>::is_always_lock_free);
+
+    std::pmr::polymorphic_allocator<T> _allocator;
+    T* _slots    = nullptr;
+    size_t _mask = 0;
+
+    // written by the producer
+    alignas(line) std::atomic<size_t> _tail{0};
+    size_t _cached_head = 0;
+
+    // written by the consumer
+    alignas(line) std::atomic<size_t> _head{0};
+    size_t _cached_tail = 0;
+
+  public:
+    explicit spsc_queue(size_t capacity,
+                        std::pmr::polymorphic_allocator<T> allocator = {})
+        : _allocator{allocator}
+    {
+        assert(capacity > 0);
+        auto slots = std::bit_ceil(capacity);
+        _slots     = _allocator.allocate(slots);
+        _mask      = slots - 1;
+    }
+
+    spsc_queue(const spsc_queue&)            = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue()
+    {
+        _allocator.deallocate(_slots, _mask + 1);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return _mask + 1;
+    }
+
+    // producer side, false when the queue is full
+    [[nodiscard]] bool push(const T& value) noexcept
+    {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cached_head == capacity())
+        {
+            _cached_head = _head.load(std::memory_order_acquire);
+            if (tail - _cached_head == capacity())
+            {
+                return false;
+            }
+        }
+        _slots[tail & _mask] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    [[nodiscard]] std::optional<T> pop() noexcept
+    {
+        auto head = _head.load(std::memory_order_relaxed);
+        if (head == _cached_tail)
+        {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            if (head == _cached_tail)
+            {
+                return std::nullopt;
+            }
+        }
+        T value = _slots[head & _mask];
+        _head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // approximate from any thread, exact from either end when the other one
+    // is idle
+    [[nodiscard]] size_t size() const noexcept
+    {
+        auto head = _head.load(std::memory_order_acquire);
+        auto tail = _tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+};
+} // namespace bit
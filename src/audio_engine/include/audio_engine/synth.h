@@ -0,0 +1,121 @@
+#pragma once
+
+#include "audio_engine/command_queue.h"
+#include "audio_engine/patch.h"
+#include "dsp/biquad.h"
+#include "dsp/bitcrusher.h"
+#include "dsp/envelope.h"
+#include "dsp/mixer.h"
+#include "dsp/polyblep.h"
+#include "dsp/smoothed.h"
+#include "math/qnumber.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace bit
+{
+// Polyphonic subtractive voice engine: every voice is a polyblep oscillator
+// through a resonant biquad low pass, the amplitude envelope and the
+// bitcrusher, and the voices are summed by the stereo mixer. Notes steal the
+// oldest voice when all of them sound.
+//
+// Voices render into their own buffers, independently of each other, so
+// render_voice() can run as one node per voice on a graph_executor; mix()
+// then reads all of them. Neither allocates.
+//
+// The master gain and the cutoff are smoothed: execute() only sets their
+// targets, prepare() moves the cutoff on once per block and recomputes the
+// filters while it changes, and mix() ramps the gain per sample.
+class synth
+{
+  public:
+    using sample_type = qs<0, 15>;
+    using bus_type    = qs<0, 23>;
+
+  private:
+    using oscillator_type = std::variant<dsp::polyblep_saw<sample_type>,
+                                         dsp::polyblep_pulse<sample_type>,
+                                         dsp::polyblep_triangle<sample_type>>;
+    using filter_type = dsp::biquad_cascade<qs<1, 30>, sample_type, 1>;
+    using gain_type   = qu<1, 31>;
+    using cutoff_type = qu<15, 17>;
+
+    struct voice
+    {
+        oscillator_type oscillator;
+        filter_type filter;
+        dsp::adsr envelope;
+        dsp::bitcrusher<sample_type> crusher;
+        std::vector<sample_type> buffer;
+        // the voice was set up for, nullptr before its first note
+        const stored_patch* program = nullptr;
+        int note                    = -1;
+        uint64_t age                = 0;
+        bool sounding               = false;
+        // buffer holds only zeros
+        bool zeroed = true;
+    };
+
+    double _sampling_frequency;
+    size_t _max_block;
+    stored_patch _initial;
+    const stored_patch* _program;
+    std::vector<voice> _voices;
+    std::vector<std::span<const sample_type>> _blocks;
+    dsp::mixer<sample_type, bus_type> _mixer;
+    dsp::smoothed<gain_type> _volume;
+    dsp::smoothed<cutoff_type> _cutoff;
+    uint64_t _notes = 0;
+
+    void update_filters() noexcept;
+    void set_up(voice& each) noexcept;
+
+  public:
+    synth(const patch& sound,
+          double sampling_frequency,
+          size_t voices    = 16,
+          size_t max_block = 256);
+
+    // plays a pointer to its own _initial
+    synth(const synth&)            = delete;
+    synth& operator=(const synth&) = delete;
+
+    [[nodiscard]] size_t voices() const noexcept
+    {
+        return _voices.size();
+    }
+
+    [[nodiscard]] size_t max_block() const noexcept
+    {
+        return _max_block;
+    }
+
+    [[nodiscard]] size_t active_voices() const noexcept;
+
+    // both take effect at the start of the next rendered block
+    void note_on(uint8_t note, uint8_t velocity) noexcept;
+    void note_off(uint8_t note) noexcept;
+    void all_notes_off() noexcept;
+
+    // render thread, for the notes from now on; the patch must outlive its
+    // use, see commands::set_program
+    void set_program(const stored_patch& program) noexcept;
+
+    // render thread, the commands meant for the synth; the others are left
+    // to the engine
+    void execute(const engine_command& command) noexcept;
+
+    // frames up to max_block; prepare() once per block before the voices
+    // when render_voice() is called directly
+    void prepare(size_t frames) noexcept;
+    void render_voice(size_t index, size_t frames) noexcept;
+    // prepares and renders every voice
+    void render(size_t frames) noexcept;
+    // sums the last rendered block, left.size() frames of it
+    void mix(std::span<bus_type> left, std::span<bus_type> right) noexcept;
+};
+} // namespace bit
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace bit
+{
+// Log-linear histogram of non-negative integers with a single writer:
+// exact below 8, then 8 buckets per power of two, so a value is known to
+// within 12.5%. Recording is a couple of relaxed loads and stores; readers
+// on other threads copy the counts while it runs and may see a count or two
+// of the block in flight missing.
+class histogram
+{
+  public:
+    static constexpr size_t sub_bits    = 3;
+    static constexpr size_t sub_buckets = size_t{1} << sub_bits;
+    static constexpr size_t buckets     = (64 - sub_bits + 1) * sub_buckets;
+
+    using counts = std::array<uint64_t, buckets>;
+
+    [[nodiscard]] static constexpr size_t bucket(uint64_t value) noexcept
+    {
+        if (value < sub_buckets)
+        {
+            return static_cast<size_t>(value);
+        }
+        auto exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+        auto mantissa = (value >> (exponent - sub_bits)) & (sub_buckets - 1);
+        return (exponent - sub_bits + 1) * sub_buckets +
+               static_cast<size_t>(mantissa);
+    }
+
+    // smallest value of the bucket
+    [[nodiscard]] static constexpr uint64_t lowest(size_t index) noexcept
+    {
+        if (index < sub_buckets)
+        {
+            return index;
+        }
+        auto exponent = index / sub_buckets + sub_bits - 1;
+        auto mantissa = index % sub_buckets;
+        return uint64_t{sub_buckets + mantissa} << (exponent - sub_bits);
+    }
+
+  private:
+    std::array<std::atomic<uint64_t>, buckets> _counts{};
+    std::atomic<uint64_t> _max{0};
+
+  public:
+    // the writer thread only
+    void record(uint64_t value) noexcept
+    {
+        auto& slot = _counts[bucket(value)];
+        slot.store(slot.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+        if (value > _max.load(std::memory_order_relaxed))
+        {
+            _max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void copy(counts& into) const noexcept
+    {
+        for (size_t i = 0; i < buckets; ++i)
+        {
+            into[i] = _counts[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] uint64_t max() const noexcept
+    {
+        return _max.load(std::memory_order_relaxed);
+    }
+};
+
+// of the recorded values, each percentile the middle of its bucket
+struct distribution
+{
+    uint64_t count = 0;
+    uint64_t p50   = 0;
+    uint64_t p99   = 0;
+    uint64_t max   = 0;
+};
+
+[[nodiscard]] distribution summarize(std::span<const uint64_t> counts,
+                                     uint64_t max) noexcept;
+
+// Plain values for the UI and for logs, times in nanoseconds and load as the
+// fraction of the deadline a block took.
+struct telemetry_snapshot
+{
+    uint64_t blocks   = 0;
+    uint64_t xruns    = 0;
+    uint64_t overruns = 0;
+    int64_t deadline  = 0;
+    distribution processing;
+    double load_p50 = 0;
+    double load_p99 = 0;
+    double load_max = 0;
+    size_t queue_depth     = 0;
+    size_t max_queue_depth = 0;
+    size_t voices          = 0;
+    size_t max_voices      = 0;
+};
+
+[[nodiscard]] std::string to_json(const telemetry_snapshot& snapshot);
+
+class engine_telemetry;
+
+// render thread, times one block from construction to destruction
+class block_timer
+{
+    engine_telemetry& _telemetry;
+    std::chrono::nanoseconds _deadline;
+    std::chrono::steady_clock::time_point _start;
+
+  public:
+    block_timer(engine_telemetry& telemetry,
+                std::chrono::nanoseconds deadline) noexcept
+        : _telemetry{telemetry}, _deadline{deadline},
+          _start{std::chrono::steady_clock::now()}
+    {
+    }
+
+    ~block_timer();
+
+    block_timer(const block_timer&)            = delete;
+    block_timer& operator=(const block_timer&) = delete;
+};
+
+// Counters of the render thread, which is their only writer: every slot is
+// an atomic the render thread stores to with relaxed order and any other
+// thread may read, so recording never waits and never allocates. A block
+// costs two clock reads and a few stores, tens of nanoseconds against a
+// block of a millisecond or more.
+//
+// snapshot() totals everything since the start; telemetry_monitor turns
+// the totals into the figures of the last interval.
+class engine_telemetry
+{
+    friend class telemetry_monitor;
+
+    histogram _processing;
+    // in 1/1024 of the deadline
+    histogram _load;
+    std::atomic<uint64_t> _blocks{0};
+    std::atomic<uint64_t> _xruns{0};
+    std::atomic<uint64_t> _overruns{0};
+    std::atomic<int64_t> _deadline{0};
+    std::atomic<size_t> _queue_depth{0};
+    std::atomic<size_t> _max_queue_depth{0};
+    std::atomic<size_t> _voices{0};
+    std::atomic<size_t> _max_voices{0};
+
+    [[nodiscard]] telemetry_snapshot counters() const noexcept;
+
+  public:
+    // render thread
+    void record_block(std::chrono::nanoseconds processing,
+                      std::chrono::nanoseconds deadline) noexcept;
+    void record_xrun() noexcept;
+    void record_queue_depth(size_t depth) noexcept;
+    void record_voices(size_t voices) noexcept;
+
+    [[nodiscard]] block_timer time_block(
+        std::chrono::nanoseconds deadline) noexcept
+    {
+        return {*this, deadline};
+    }
+
+    // any thread
+    [[nodiscard]] telemetry_snapshot snapshot() const noexcept;
+};
+
+// Reader side: every poll() covers the blocks recorded since the previous
+// one, so the percentiles follow the current load instead of the whole run.
+class telemetry_monitor
+{
+    const engine_telemetry& _telemetry;
+    histogram::counts _processing{};
+    histogram::counts _load{};
+    telemetry_snapshot _previous;
+
+  public:
+    explicit telemetry_monitor(const engine_telemetry& telemetry) noexcept
+        : _telemetry{telemetry}
+    {
+    }
+
+    // max_queue_depth and max_voices stay the maxima of the whole run,
+    // processing.max and load_max are of the interval's top bucket
+    [[nodiscard]] telemetry_snapshot poll() noexcept;
+};
+} // namespace bit
@@ -0,0 +1,156 @@
+#include <audio_engine/graph.h>
+
+#include <cassert>
+#include <stdexcept>
+
+namespace bit
+{
+node_id processing_graph::add(node_process process)
+{
+    _nodes.push_back(std::move(process));
+    return static_cast<node_id>(_nodes.size() - 1);
+}
+
+void processing_graph::connect(node_id from, node_id to)
+{
+    if (from >= _nodes.size() or to >= _nodes.size())
+    {
+        throw std::out_of_range{"connecting a node that isn't in the graph"};
+    }
+    _edges.emplace_back(from, to);
+}
+
+std::unique_ptr<graph_schedule> processing_graph::compile() const
+{
+    // unique_ptr, the schedule holds atomics and is handed over by pointer
+    std::unique_ptr<graph_schedule> schedule{new graph_schedule};
+    auto count         = _nodes.size();
+    auto& first        = schedule->_first;
+    auto& dependents   = schedule->_dependents;
+    auto& dependencies = schedule->_dependencies;
+
+    // dependents of every node, bucketed by their source
+    first.assign(count + 1, 0);
+    dependencies.assign(count, 0);
+    for (auto [from, to] : _edges)
+    {
+        ++first[from + 1];
+        ++dependencies[to];
+    }
+    for (size_t n = 0; n < count; ++n)
+    {
+        first[n + 1] += first[n];
+    }
+    dependents.resize(_edges.size());
+    auto next = first;
+    for (auto [from, to] : _edges)
+    {
+        dependents[next[from]++] = to;
+    }
+
+    // Kahn's algorithm, the order doubles as the queue
+    auto& order    = schedule->_order;
+    auto remaining = dependencies;
+    order.reserve(count);
+    for (node_id n = 0; n < count; ++n)
+    {
+        if (remaining[n] == 0)
+        {
+            order.push_back(n);
+        }
+    }
+    schedule->_roots = order;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        auto node = order[i];
+        for (auto d = first[node]; d < first[node + 1]; ++d)
+        {
+            if (--remaining[dependents[d]] == 0)
+            {
+                order.push_back(dependents[d]);
+            }
+        }
+    }
+    if (order.size() != count)
+    {
+        throw std::runtime_error{"processing graph has a cycle"};
+    }
+
+    schedule->_nodes     = _nodes;
+    schedule->_remaining = std::make_unique<std::atomic<uint32_t>[]>(count);
+    schedule->_ready     = std::make_unique<std::atomic<node_id>[]>(count);
+    return schedule;
+}
+
+void graph_schedule::run(size_t frames) const
+{
+    for (auto node : _order)
+    {
+        _nodes[node](frames);
+    }
+}
+
+void graph_schedule::reset(uint32_t block) noexcept
+{
+    auto count = static_cast<uint32_t>(_nodes.size());
+    // nobody can claim a ticket until the new block is published
+    _head.store(uint64_t{block - 1} << 32 | count, std::memory_order_relaxed);
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        _remaining[n].store(_dependencies[n], std::memory_order_relaxed);
+        _ready[n].store(none, std::memory_order_relaxed);
+    }
+    _tail.store(0, std::memory_order_relaxed);
+    _done.store(0, std::memory_order_relaxed);
+    for (auto root : _roots)
+    {
+        ready(root);
+    }
+    _head.store(uint64_t{block} << 32, std::memory_order_release);
+}
+
+void graph_schedule::ready(node_id node) noexcept
+{
+    auto slot = _tail.fetch_add(1, std::memory_order_relaxed);
+    assert(slot < _nodes.size());
+    _ready[slot].store(node, std::memory_order_release);
+}
+
+void graph_schedule::drain(uint32_t block, size_t frames) noexcept
+{
+    auto count = static_cast<uint32_t>(_nodes.size());
+    auto head  = _head.load(std::memory_order_acquire);
+    while (head >> 32 == block and static_cast<uint32_t>(head) < count)
+    {
+        if (not _head.compare_exchange_weak(head,
+                                            head + 1,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire))
+        {
+            continue;
+        }
+        // Tickets are handed out in the order nodes become ready, so the
+        // slot is either filled or about to be, by a node that's running.
+        auto ticket = static_cast<uint32_t>(head);
+        auto node   = _ready[ticket].load(std::memory_order_acquire);
+        for (size_t spins = 0; node == none; detail::backoff(spins))
+        {
+            node = _ready[ticket].load(std::memory_order_acquire);
+        }
+
+        _nodes[node](frames);
+
+        for (auto d = _first[node]; d < _first[node + 1]; ++d)
+        {
+            auto dependent = _dependents[d];
+            if (_remaining[dependent].fetch_sub(
+                    1, std::memory_order_acq_rel) == 1)
+            {
+                ready(dependent);
+            }
+        }
+        _done.fetch_add(1, std::memory_order_release);
+        head = _head.load(std::memory_order_acquire);
+    }
+}
+} // namespace bit
@@ -0,0 +1,117 @@
+#include <audio_engine/graph_executor.h>
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace bit
+{
+namespace
+{
+// best effort, containers and some schedulers don't allow it
+void pin_to(size_t cpu) noexcept
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    if (cpu < sizeof(DWORD_PTR) * 8)
+    {
+        SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu);
+    }
+#else
+    (void)cpu;
+#endif
+}
+} // namespace
+
+size_t graph_executor::default_workers() noexcept
+{
+    auto cores = static_cast<size_t>(std::thread::hardware_concurrency());
+    return std::max<size_t>(cores, 1) - 1;
+}
+
+graph_executor::graph_executor(size_t workers)
+{
+    auto cores =
+        std::max<size_t>(std::thread::hardware_concurrency(), workers + 1);
+    _workers.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+    {
+        // core 0 is left to the render thread
+        _workers.emplace_back([this, cpu = (i + 1) % cores] { work(cpu); });
+    }
+}
+
+graph_executor::~graph_executor()
+{
+    _stopping.store(true, std::memory_order_release);
+    // sequentially consistent, notify_all() mustn't see the count of
+    // sleeping workers from before the change
+    _block.fetch_add(1);
+    _block.notify_all();
+}
+
+void graph_executor::work(size_t cpu) noexcept
+{
+    pin_to(cpu);
+    // the block the pool was created at, not the current one: a worker can
+    // start late enough to miss run() and even the destructor
+    uint32_t seen = 0;
+    while (true)
+    {
+        for (size_t spins = 0;
+             spins < spin_limit and
+             _block.load(std::memory_order_acquire) == seen;
+             ++spins)
+        {
+        }
+        _block.wait(seen, std::memory_order_acquire);
+        seen = _block.load(std::memory_order_acquire);
+        if (_stopping.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        // run() waits for _active to drop to zero after clearing the
+        // schedule, so it's either still alive here or already nullptr
+        _active.fetch_add(1);
+        if (auto* schedule = _schedule.load())
+        {
+            schedule->drain(seen, _frames.load(std::memory_order_relaxed));
+        }
+        _active.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void graph_executor::run(graph_schedule& schedule, size_t frames) noexcept
+{
+    auto count = static_cast<uint32_t>(schedule.size());
+    auto block = _block.load(std::memory_order_relaxed) + 1;
+    schedule.reset(block);
+    _frames.store(frames, std::memory_order_relaxed);
+    _schedule.store(&schedule);
+    _block.store(block);
+    _block.notify_all();
+
+    schedule.drain(block, frames);
+    // the last nodes may still be running on the workers
+    for (size_t spins = 0;
+         schedule._done.load(std::memory_order_acquire) < count;
+         detail::backoff(spins))
+    {
+    }
+    _schedule.store(nullptr);
+    for (size_t spins = 0; _active.load() != 0; detail::backoff(spins))
+    {
+    }
+}
+} // namespace bit
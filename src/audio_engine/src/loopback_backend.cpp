@@ -0,0 +1,131 @@
+#include <audio_engine/loopback_backend.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace bit
+{
+namespace
+{
+using steady = std::chrono::steady_clock;
+
+int64_t nanoseconds_since(steady::time_point origin) noexcept
+{
+    auto elapsed = steady::now() - origin;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+        .count();
+}
+
+// splitmix64, a reproducible sequence indexed by the block
+uint64_t mix(uint64_t seed, uint64_t index) noexcept
+{
+    auto z = seed + (index + 1) * 0x9e3779b97f4a7c15u;
+    z      = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z      = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+}
+
+#if defined(__linux__)
+// both clocks are CLOCK_MONOTONIC on Linux
+void sleep_until(steady::time_point when) noexcept
+{
+    using std::chrono::duration_cast;
+    auto since_epoch = when.time_since_epoch();
+    auto seconds     = duration_cast<std::chrono::seconds>(since_epoch);
+    auto rest = duration_cast<std::chrono::nanoseconds>(since_epoch - seconds);
+    timespec deadline{static_cast<time_t>(seconds.count()),
+                      static_cast<long>(rest.count())};
+    while (clock_nanosleep(
+               CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+    {
+    }
+}
+#else
+void sleep_until(steady::time_point when) noexcept
+{
+    std::this_thread::sleep_until(when);
+}
+#endif
+} // namespace
+
+loopback_backend::loopback_backend(const loopback_settings& settings)
+    : _settings{settings}
+{
+    if (settings.sampling_frequency <= 0 or settings.buffer_frames == 0 or
+        settings.channels == 0)
+    {
+        throw std::range_error{
+            "Loopback needs a positive rate, buffer size and channel count"};
+    }
+    _buffer.resize(settings.buffer_frames * settings.channels);
+}
+
+int64_t loopback_backend::period_start(size_t block) const noexcept
+{
+    // from the block index, so that rounding doesn't drift
+    return std::llround(static_cast<double>(block * _settings.buffer_frames) *
+                        1e9 / _settings.sampling_frequency);
+}
+
+int64_t loopback_backend::jitter(size_t block) const noexcept
+{
+    auto range = static_cast<uint64_t>(_settings.jitter.count());
+    if (range == 0)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(mix(_settings.seed, block) % (range + 1));
+}
+
+void loopback_backend::run(size_t blocks, const render_callback& render)
+{
+    _timings.assign(blocks, {});
+    _captured.clear();
+    if (_settings.capture)
+    {
+        _captured.reserve(blocks * _buffer.size());
+    }
+    _misses = 0;
+
+    auto origin      = steady::now();
+    auto realtime    = _settings.clock == loopback_clock::realtime;
+    int64_t previous = 0;
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        auto& timing     = _timings[block];
+        timing.scheduled = period_start(block);
+        timing.deadline  = period_start(block + 1);
+        auto wake        = timing.scheduled + jitter(block);
+
+        if (realtime)
+        {
+            sleep_until(origin + std::chrono::nanoseconds{wake});
+            timing.started = nanoseconds_since(origin);
+            render(_buffer);
+            timing.finished = nanoseconds_since(origin);
+        }
+        else
+        {
+            // the render thread can't start before the last block is done
+            timing.started = std::max(wake, previous);
+            auto begin     = steady::now();
+            render(_buffer);
+            timing.finished = timing.started + nanoseconds_since(begin);
+            previous        = timing.finished;
+        }
+
+        _misses += timing.missed() ? 1 : 0;
+        if (_settings.capture)
+        {
+            _captured.insert(_captured.end(), _buffer.begin(), _buffer.end());
+        }
+    }
+}
+} // namespace bit
@@ -0,0 +1,54 @@
+#include <audio_engine/patch.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace bit
+{
+namespace
+{
+// highest the cutoff field holds
+constexpr double max_cutoff = 32'767;
+} // namespace
+
+stored_patch to_stored_patch(const patch& sound, std::string_view name)
+{
+    stored_patch stored{};
+    if (name.size() > stored.name.size())
+    {
+        throw std::range_error{"patch name longer than 28 characters"};
+    }
+    std::ranges::copy(name, stored.name.begin());
+    stored.attack    = qu<8, 24>{sound.attack};
+    stored.decay     = qu<8, 24>{sound.decay};
+    stored.release   = qu<8, 24>{sound.release};
+    stored.smoothing = qu<8, 24>{sound.smoothing};
+    stored.sustain   = qu<1, 31>{std::clamp(sound.sustain, 0.0, 1.0)};
+    stored.gain      = qu<1, 31>{sound.gain};
+    stored.cutoff    = qu<15, 17>{std::clamp(sound.cutoff, 0.0, max_cutoff)};
+    stored.resonance = qu<4, 28>{sound.resonance};
+    stored.hold =
+        static_cast<uint16_t>(std::clamp<size_t>(sound.hold, 1, 0xffff));
+    stored.shape = static_cast<uint8_t>(sound.shape);
+    stored.depth =
+        static_cast<uint8_t>(std::clamp<size_t>(sound.depth, 1, 16));
+    return stored;
+}
+
+patch to_patch(const stored_patch& stored) noexcept
+{
+    return {
+        .shape     = static_cast<dsp::waveform>(stored.shape),
+        .attack    = stored.attack.as<double>(),
+        .decay     = stored.decay.as<double>(),
+        .sustain   = stored.sustain.as<double>(),
+        .release   = stored.release.as<double>(),
+        .cutoff    = stored.cutoff.as<double>(),
+        .resonance = stored.resonance.as<double>(),
+        .depth     = stored.depth,
+        .hold      = stored.hold,
+        .gain      = stored.gain.as<double>(),
+        .smoothing = stored.smoothing.as<double>(),
+    };
+}
+} // namespace bit
@@ -0,0 +1,146 @@
+#include <audio_engine/patch_bank.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace bit
+{
+// the file is used in place, so its byte order has to be the machine's
+static_assert(std::endian::native == std::endian::little,
+              "patch banks are little endian");
+
+namespace
+{
+void require(bool condition, const char* what)
+{
+    if (not condition)
+    {
+        throw std::runtime_error{std::string{"patch bank: "} + what};
+    }
+}
+
+// FNV-1a over 64 bit words in four interleaved lanes, so that the
+// multiplications overlap, then over the lanes and the bytes left over.
+// Every step is a bijection of the state, so a change to any one word
+// always shows.
+uint64_t checksum(std::span<const uint8_t> bytes) noexcept
+{
+    constexpr uint64_t basis = 0xcbf2'9ce4'8422'2325;
+    constexpr uint64_t prime = 0x100'0000'01b3;
+    constexpr size_t lanes   = 4;
+    std::array<uint64_t, lanes> hashes;
+    hashes.fill(basis);
+
+    constexpr size_t stride = lanes * sizeof(uint64_t);
+    size_t i                = 0;
+    for (; i + stride <= bytes.size(); i += stride)
+    {
+        for (size_t j = 0; j < lanes; ++j)
+        {
+            uint64_t word;
+            std::memcpy(&word, &bytes[i + j * sizeof(word)], sizeof(word));
+            hashes[j] = (hashes[j] ^ word) * prime;
+        }
+    }
+
+    auto hash = basis;
+    for (auto each : hashes)
+    {
+        hash = (hash ^ each) * prime;
+    }
+    for (; i < bytes.size(); ++i)
+    {
+        hash = (hash ^ bytes[i]) * prime;
+    }
+    return hash;
+}
+
+bool is_valid(const stored_patch& stored) noexcept
+{
+    return stored.shape <= static_cast<uint8_t>(dsp::waveform::triangle) and
+           stored.depth >= 1 and stored.depth <= 16 and stored.hold >= 1;
+}
+} // namespace
+
+patch_bank::patch_bank(const std::filesystem::path& path)
+    : _file{std::in_place, path}
+{
+    load(_file->bytes());
+}
+
+patch_bank::patch_bank(std::span<const uint8_t> bytes)
+{
+    load(bytes);
+}
+
+void patch_bank::load(std::span<const uint8_t> bytes)
+{
+    patch_bank_header header;
+    require(bytes.size() >= sizeof(header), "missing header");
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    require(header.magic == magic, "not a patch bank");
+    require(header.version == version, "unsupported version");
+    require(header.patch_size == sizeof(stored_patch), "unexpected layout");
+    auto address = reinterpret_cast<uintptr_t>(bytes.data());
+    require(address % alignof(patch_bank_header) == 0, "misaligned data");
+
+    auto patches_size = size_t{header.patches} * sizeof(stored_patch);
+    auto tables_size  = size_t{header.tables} * header.table_length *
+                       sizeof(table_sample);
+    require(bytes.size() == sizeof(header) + patches_size + tables_size,
+            "size doesn't match the header");
+    auto payload = bytes.subspan(sizeof(header));
+    require(checksum(payload) == header.checksum, "checksum mismatch");
+
+    // the bytes are a valid, suitably aligned array of these trivially
+    // copyable types, so they are read in place
+    _patches = {reinterpret_cast<const stored_patch*>(payload.data()),
+                header.patches};
+    _tables  = {reinterpret_cast<const table_sample*>(payload.data() +
+                                                     patches_size),
+                size_t{header.tables} * header.table_length};
+    _table_length = header.tables == 0 ? 0 : header.table_length;
+    require(std::ranges::all_of(_patches, is_valid), "invalid patch");
+}
+
+const stored_patch* patch_bank::find(std::string_view name) const noexcept
+{
+    auto found = std::ranges::find(_patches, name, &stored_patch::label);
+    return found == _patches.end() ? nullptr : &*found;
+}
+
+std::vector<uint8_t> pack_patch_bank(
+    std::span<const stored_patch> patches,
+    std::span<const patch_bank::table_sample> tables,
+    size_t table_length)
+{
+    assert(table_length == 0 ? tables.empty()
+                             : tables.size() % table_length == 0);
+    patch_bank_header header{
+        .magic        = patch_bank::magic,
+        .version      = patch_bank::version,
+        .patch_size   = sizeof(stored_patch),
+        .patches      = static_cast<uint32_t>(patches.size()),
+        .tables       = static_cast<uint32_t>(
+            table_length == 0 ? 0 : tables.size() / table_length),
+        .table_length = static_cast<uint32_t>(table_length),
+        .reserved     = 0,
+        .checksum     = 0,
+    };
+    std::vector<uint8_t> bytes(sizeof(header));
+    auto append = [&](std::span<const std::byte> data) {
+        auto begin = reinterpret_cast<const uint8_t*>(data.data());
+        bytes.insert(bytes.end(), begin, begin + data.size());
+    };
+    append(std::as_bytes(patches));
+    append(std::as_bytes(tables));
+    header.checksum = checksum(std::span{bytes}.subspan(sizeof(header)));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return bytes;
+}
+} // namespace bit
@@ -0,0 +1,262 @@
+#include <audio_engine/synth.h>
+
+#include "dsp/phase.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+
+namespace bit
+{
+namespace
+{
+double note_frequency(uint8_t note, double sampling_frequency)
+{
+    auto frequency = 440.0 * std::exp2((note - 69) / 12.0);
+    // the top notes at low rates would alias past Nyquist
+    return std::min(frequency, 0.45 * sampling_frequency);
+}
+
+size_t samples(double seconds, double sampling_frequency)
+{
+    return static_cast<size_t>(std::lround(seconds * sampling_frequency));
+}
+
+// highest the cutoff type holds
+constexpr double max_cutoff = 32'767;
+} // namespace
+
+synth::synth(const patch& sound,
+             double sampling_frequency,
+             size_t voices,
+             size_t max_block)
+    : _sampling_frequency{sampling_frequency}, _max_block{max_block},
+      _initial{to_stored_patch(sound)}, _program{&_initial},
+      _voices(voices), _mixer{voices},
+      _volume{gain_type{1.0},
+              samples(sound.smoothing, sampling_frequency),
+              dsp::ramp_shape::linear},
+      _cutoff{_initial.cutoff,
+              samples(sound.smoothing, sampling_frequency),
+              dsp::ramp_shape::exponential}
+{
+    assert(max_block > 0);
+    for (auto& each : _voices)
+    {
+        each.buffer.resize(max_block);
+    }
+    _blocks.resize(voices);
+    update_filters();
+}
+
+void synth::update_filters() noexcept
+{
+    auto cutoff = std::clamp(_cutoff.current().as<double>() /
+                                 _sampling_frequency,
+                             1e-4,
+                             0.45);
+    auto coefficients = dsp::lowpass_biquad<filter_type::coefficient_type>(
+        cutoff, _program->resonance.as<double>());
+    for (auto& each : _voices)
+    {
+        each.filter.set_coefficients({coefficients});
+    }
+}
+
+void synth::set_up(voice& each) noexcept
+{
+    const auto& program = *_program;
+    switch (static_cast<dsp::waveform>(program.shape))
+    {
+    case dsp::waveform::saw:
+        each.oscillator.emplace<dsp::polyblep_saw<sample_type>>();
+        break;
+    case dsp::waveform::pulse:
+        each.oscillator.emplace<dsp::polyblep_pulse<sample_type>>();
+        break;
+    case dsp::waveform::triangle:
+        each.oscillator.emplace<dsp::polyblep_triangle<sample_type>>();
+        break;
+    }
+    auto time = [this](qu<8, 24> seconds) {
+        return samples(seconds.as<double>(), _sampling_frequency);
+    };
+    each.envelope.set_parameters({
+        .attack        = time(program.attack),
+        .decay         = time(program.decay),
+        .sustain       = program.sustain,
+        .release       = time(program.release),
+        .decay_curve   = dsp::envelope_curve::exponential,
+        .release_curve = dsp::envelope_curve::exponential,
+    });
+    each.crusher = dsp::bitcrusher<sample_type>{program.depth, program.hold};
+    each.program = _program;
+}
+
+size_t synth::active_voices() const noexcept
+{
+    return static_cast<size_t>(std::ranges::count_if(
+        _voices, [](const voice& each) { return each.sounding; }));
+}
+
+void synth::note_on(uint8_t note, uint8_t velocity) noexcept
+{
+    // the voice already playing the note, a free one or the oldest
+    auto chosen = std::ranges::find(_voices, note, &voice::note);
+    if (chosen == _voices.end())
+    {
+        chosen = std::ranges::find_if(_voices, [](const voice& each) {
+            return not each.envelope.is_active();
+        });
+    }
+    if (chosen == _voices.end())
+    {
+        chosen = std::ranges::min_element(_voices, {}, &voice::age);
+    }
+
+    if (chosen->program != _program)
+    {
+        set_up(*chosen);
+    }
+    auto increment =
+        dsp::phase_increment(note_frequency(note, _sampling_frequency),
+                             _sampling_frequency);
+    std::visit([&](auto& oscillator) { oscillator.set_increment(increment); },
+               chosen->oscillator);
+    chosen->note     = note;
+    chosen->age      = ++_notes;
+    chosen->sounding = true;
+    chosen->envelope.trigger();
+    auto index = static_cast<size_t>(chosen - _voices.begin());
+    _mixer.set_voice(
+        index, _program->gain.as<double>() * velocity / 127.0, 0.0);
+}
+
+void synth::note_off(uint8_t note) noexcept
+{
+    for (auto& each : _voices)
+    {
+        if (each.note == note)
+        {
+            each.envelope.release();
+            each.note = -1;
+        }
+    }
+}
+
+void synth::all_notes_off() noexcept
+{
+    for (auto& each : _voices)
+    {
+        if (each.note >= 0)
+        {
+            each.envelope.release();
+            each.note = -1;
+        }
+    }
+}
+
+void synth::set_program(const stored_patch& program) noexcept
+{
+    _program    = &program;
+    auto length = samples(program.smoothing.as<double>(), _sampling_frequency);
+    _volume.set_ramp(length, dsp::ramp_shape::linear);
+    _cutoff.set_ramp(length, dsp::ramp_shape::exponential);
+    _cutoff.set_target(program.cutoff);
+    // for the resonance, the cutoff follows block by block
+    update_filters();
+}
+
+void synth::execute(const engine_command& command) noexcept
+{
+    std::visit(
+        [this]<typename T>(const T& message) {
+            if constexpr (std::same_as<T, commands::set_gain>)
+            {
+                _volume.set_target(gain_type{
+                    std::clamp(static_cast<double>(message.gain), 0.0, 1.99)});
+            }
+            else if constexpr (std::same_as<T, commands::set_cutoff>)
+            {
+                _cutoff.set_target(cutoff_type{std::clamp(
+                    static_cast<double>(message.hertz), 0.0, max_cutoff)});
+            }
+            else if constexpr (std::same_as<T, commands::set_program>)
+            {
+                set_program(*message.patch);
+            }
+            else if constexpr (std::same_as<T, commands::set_bit_depth>)
+            {
+                auto depth = std::clamp<size_t>(
+                    message.depth, 1, sample_type::bits + 1);
+                for (auto& each : _voices)
+                {
+                    each.crusher.set_depth(depth);
+                }
+            }
+        },
+        command);
+}
+
+void synth::prepare(size_t frames) noexcept
+{
+    // the coefficients once per block, only while the cutoff moves
+    if (_cutoff.is_smoothing())
+    {
+        _cutoff.advance(frames);
+        update_filters();
+    }
+}
+
+void synth::render_voice(size_t index, size_t frames) noexcept
+{
+    assert(frames <= _max_block);
+    auto& each = _voices[index];
+    if (not each.sounding)
+    {
+        if (not each.zeroed)
+        {
+            std::ranges::fill(each.buffer, sample_type{});
+            each.zeroed = true;
+        }
+        return;
+    }
+    each.zeroed = false;
+    auto block = std::span{each.buffer}.first(frames);
+    std::visit([&](auto& oscillator) { oscillator.render(block); },
+               each.oscillator);
+    each.filter.process(block);
+    each.envelope.apply(block);
+    each.crusher.process(block);
+
+    if (not each.envelope.is_active())
+    {
+        // the release ended within this block
+        each.filter.reset();
+        each.crusher.reset();
+        each.sounding = false;
+    }
+}
+
+void synth::render(size_t frames) noexcept
+{
+    prepare(frames);
+    for (size_t v = 0; v < _voices.size(); ++v)
+    {
+        render_voice(v, frames);
+    }
+}
+
+void synth::mix(std::span<bus_type> left, std::span<bus_type> right) noexcept
+{
+    assert(left.size() <= _max_block);
+    for (size_t v = 0; v < _voices.size(); ++v)
+    {
+        _blocks[v] = std::span<const sample_type>{_voices[v].buffer}.first(
+            left.size());
+    }
+    _mixer.mix(_blocks, left, right);
+    _volume.apply(left, right);
+}
+} // namespace bit
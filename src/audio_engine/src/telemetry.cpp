@@ -0,0 +1,214 @@
+#include <audio_engine/telemetry.h>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <limits>
+
+namespace bit
+{
+namespace
+{
+constexpr uint64_t load_unit = 1024;
+
+// largest value of the bucket
+uint64_t highest(size_t index) noexcept
+{
+    return index + 1 < histogram::buckets
+               ? histogram::lowest(index + 1) - 1
+               : std::numeric_limits<uint64_t>::max();
+}
+
+template <typename T>
+void store_max(std::atomic<T>& slot, T value) noexcept
+{
+    if (value > slot.load(std::memory_order_relaxed))
+    {
+        slot.store(value, std::memory_order_relaxed);
+    }
+}
+
+template <typename T> void increment(std::atomic<T>& slot) noexcept
+{
+    slot.store(slot.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+}
+
+// the interval's maximum is only known to the top non-empty bucket
+uint64_t top(std::span<const uint64_t> counts, uint64_t max) noexcept
+{
+    for (size_t i = counts.size(); i-- > 0;)
+    {
+        if (counts[i] > 0)
+        {
+            return std::min(highest(i), max);
+        }
+    }
+    return 0;
+}
+
+double load(uint64_t value) noexcept
+{
+    return static_cast<double>(value) / load_unit;
+}
+
+void fill_load(telemetry_snapshot& snapshot,
+               std::span<const uint64_t> counts,
+               uint64_t max) noexcept
+{
+    auto summary      = summarize(counts, max);
+    snapshot.load_p50 = load(summary.p50);
+    snapshot.load_p99 = load(summary.p99);
+    snapshot.load_max = load(summary.max);
+}
+} // namespace
+
+distribution summarize(std::span<const uint64_t> counts, uint64_t max) noexcept
+{
+    distribution summary;
+    for (auto count : counts)
+    {
+        summary.count += count;
+    }
+    if (summary.count == 0)
+    {
+        return summary;
+    }
+    summary.max = max;
+
+    // the smallest bucket holding at least the fraction of the values
+    auto percentile = [&](uint64_t per_thousand) {
+        auto wanted    = (summary.count * per_thousand + 999) / 1000;
+        uint64_t below = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            below += counts[i];
+            if (below >= wanted)
+            {
+                auto low = histogram::lowest(i);
+                return std::min(low + (highest(i) - low) / 2, max);
+            }
+        }
+        return max;
+    };
+    summary.p50 = percentile(500);
+    summary.p99 = percentile(990);
+    return summary;
+}
+
+std::string to_json(const telemetry_snapshot& snapshot)
+{
+    return fmt::format(
+        R"({{"blocks":{},"xruns":{},"overruns":{},"deadline_ns":{},)"
+        R"("processing_ns":{{"count":{},"p50":{},"p99":{},"max":{}}},)"
+        R"("load":{{"p50":{:.4f},"p99":{:.4f},"max":{:.4f}}},)"
+        R"("queue_depth":{},"max_queue_depth":{},)"
+        R"("voices":{},"max_voices":{}}})",
+        snapshot.blocks,
+        snapshot.xruns,
+        snapshot.overruns,
+        snapshot.deadline,
+        snapshot.processing.count,
+        snapshot.processing.p50,
+        snapshot.processing.p99,
+        snapshot.processing.max,
+        snapshot.load_p50,
+        snapshot.load_p99,
+        snapshot.load_max,
+        snapshot.queue_depth,
+        snapshot.max_queue_depth,
+        snapshot.voices,
+        snapshot.max_voices);
+}
+
+block_timer::~block_timer()
+{
+    _telemetry.record_block(std::chrono::steady_clock::now() - _start,
+                            _deadline);
+}
+
+void engine_telemetry::record_block(std::chrono::nanoseconds processing,
+                                    std::chrono::nanoseconds deadline) noexcept
+{
+    using rep   = std::chrono::nanoseconds::rep;
+    auto spent  = static_cast<uint64_t>(std::max<rep>(processing.count(), 0));
+    auto budget = static_cast<uint64_t>(std::max<rep>(deadline.count(), 1));
+    _processing.record(spent);
+    _load.record(spent * load_unit / budget);
+    _deadline.store(deadline.count(), std::memory_order_relaxed);
+    if (processing > deadline)
+    {
+        increment(_overruns);
+    }
+    increment(_blocks);
+}
+
+void engine_telemetry::record_xrun() noexcept
+{
+    increment(_xruns);
+}
+
+void engine_telemetry::record_queue_depth(size_t depth) noexcept
+{
+    _queue_depth.store(depth, std::memory_order_relaxed);
+    store_max(_max_queue_depth, depth);
+}
+
+void engine_telemetry::record_voices(size_t voices) noexcept
+{
+    _voices.store(voices, std::memory_order_relaxed);
+    store_max(_max_voices, voices);
+}
+
+telemetry_snapshot engine_telemetry::counters() const noexcept
+{
+    telemetry_snapshot snapshot;
+    snapshot.blocks          = _blocks.load(std::memory_order_relaxed);
+    snapshot.xruns           = _xruns.load(std::memory_order_relaxed);
+    snapshot.overruns        = _overruns.load(std::memory_order_relaxed);
+    snapshot.deadline        = _deadline.load(std::memory_order_relaxed);
+    snapshot.queue_depth     = _queue_depth.load(std::memory_order_relaxed);
+    snapshot.max_queue_depth =
+        _max_queue_depth.load(std::memory_order_relaxed);
+    snapshot.voices          = _voices.load(std::memory_order_relaxed);
+    snapshot.max_voices      = _max_voices.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+telemetry_snapshot engine_telemetry::snapshot() const noexcept
+{
+    auto totals = counters();
+    histogram::counts counts;
+    _processing.copy(counts);
+    totals.processing = summarize(counts, _processing.max());
+    _load.copy(counts);
+    fill_load(totals, counts, _load.max());
+    return totals;
+}
+
+telemetry_snapshot telemetry_monitor::poll() noexcept
+{
+    auto snapshot = _telemetry.counters();
+    histogram::counts counts;
+    // leaves the counts of the interval in counts
+    auto interval = [&](const histogram& source, histogram::counts& last) {
+        source.copy(counts);
+        for (size_t i = 0; i < histogram::buckets; ++i)
+        {
+            std::swap(counts[i], last[i]);
+            counts[i] = last[i] - counts[i];
+        }
+        return top(counts, source.max());
+    };
+    auto processing_max = interval(_telemetry._processing, _processing);
+    snapshot.processing = summarize(counts, processing_max);
+    auto load_max       = interval(_telemetry._load, _load);
+    fill_load(snapshot, counts, load_max);
+
+    auto total = snapshot;
+    snapshot.blocks -= _previous.blocks;
+    snapshot.xruns -= _previous.xruns;
+    snapshot.overruns -= _previous.overruns;
+    _previous = total;
+    return snapshot;
+}
+} // namespace bit
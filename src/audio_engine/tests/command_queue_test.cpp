@@ -0,0 +1,122 @@
+#include <audio_engine/command_queue.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace
+{
+std::atomic<size_t> destroyed{0};
+
+struct table
+{
+    int id;
+
+    ~table()
+    {
+        ++destroyed;
+    }
+};
+
+struct render_state
+{
+    uint8_t depth          = 16;
+    float hertz            = 0;
+    table* current         = nullptr;
+    void (*destroy)(void*) = nullptr;
+    std::vector<float> frequencies;
+};
+} // namespace
+
+TEST_CASE("commands reach the render thread in order and old objects come "
+          "back",
+          "[audio_engine|command_queue]")
+{
+    constexpr size_t count = 20'000;
+    bit::engine_command_queue queue{64};
+    render_state state;
+    state.frequencies.reserve(count);
+    destroyed = 0;
+    std::atomic<bool> stop{false};
+
+    std::jthread render{[&] {
+        auto handle = [&](const bit::engine_command& command) {
+            std::visit(
+                [&]<typename T>(const T& message) {
+                    if constexpr (std::same_as<T, bit::commands::set_bit_depth>)
+                    {
+                        state.depth = message.depth;
+                    }
+                    else if constexpr (std::same_as<
+                                           T,
+                                           bit::commands::set_frequency>)
+                    {
+                        state.hertz = message.hertz;
+                        state.frequencies.push_back(message.hertz);
+                    }
+                    else if constexpr (std::same_as<
+                                           T,
+                                           bit::commands::swap_object>)
+                    {
+                        if (state.current)
+                        {
+                            while (not queue.retire(
+                                {state.current, state.destroy}))
+                            {
+                            }
+                        }
+                        state.current = static_cast<table*>(message.object);
+                        state.destroy = message.destroy;
+                    }
+                },
+                command);
+        };
+        while (not stop)
+        {
+            queue.dispatch(handle);
+        }
+        queue.dispatch(handle);
+    }};
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto* replacement = new table{static_cast<int>(i)};
+        auto retired      = bit::retire(replacement);
+        while (not queue.send(bit::commands::swap_object{
+            0, retired.object, retired.destroy}))
+        {
+            queue.collect();
+        }
+        while (not queue.send(
+            bit::commands::set_frequency{static_cast<float>(i)}))
+        {
+            queue.collect();
+        }
+    }
+    while (not queue.send(bit::commands::set_bit_depth{8}))
+    {
+        queue.collect();
+    }
+    // the render thread may wait for room in the return queue
+    while (queue.pending() > 0)
+    {
+        queue.collect();
+    }
+    stop = true;
+    render.join();
+    queue.collect();
+
+    CHECK(state.depth == 8);
+    REQUIRE(state.frequencies.size() == count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        REQUIRE(state.frequencies[i] == static_cast<float>(i));
+    }
+    // every table but the one in use went back and was freed here
+    CHECK(destroyed == count - 1);
+    REQUIRE(state.current != nullptr);
+    CHECK(state.current->id == static_cast<int>(count - 1));
+    bit::retired{state.current, state.destroy}.release();
+}
@@ -0,0 +1,197 @@
+#include <audio_engine/graph.h>
+#include <audio_engine/graph_executor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+// records the position every node ran at
+struct trace
+{
+    std::atomic<uint32_t> next{0};
+    std::vector<std::atomic<uint32_t>> positions;
+
+    explicit trace(size_t nodes) : positions(nodes)
+    {
+    }
+
+    bit::node_process node(bit::node_id id)
+    {
+        return [this, id](size_t) { positions[id] = next++; };
+    }
+};
+
+// voices feeding a mixer, the mix feeding two effect sends and both sends
+// feeding the master
+bit::processing_graph voices_and_sends(trace& nodes, size_t voices)
+{
+    bit::processing_graph graph;
+    std::vector<bit::node_id> chains;
+    for (size_t v = 0; v < voices; ++v)
+    {
+        chains.push_back(graph.add(nodes.node(graph.size())));
+    }
+    auto mix = graph.add(nodes.node(graph.size()));
+    for (auto chain : chains)
+    {
+        graph.connect(chain, mix);
+    }
+    auto reverb = graph.add(nodes.node(graph.size()));
+    auto delay  = graph.add(nodes.node(graph.size()));
+    auto master = graph.add(nodes.node(graph.size()));
+    graph.connect(mix, reverb);
+    graph.connect(mix, delay);
+    graph.connect(reverb, master);
+    graph.connect(delay, master);
+    graph.connect(mix, master);
+    return graph;
+}
+
+void check_dependencies(const trace& nodes, size_t voices)
+{
+    auto mix    = voices;
+    auto reverb = voices + 1;
+    auto delay  = voices + 2;
+    auto master = voices + 3;
+    for (size_t v = 0; v < voices; ++v)
+    {
+        REQUIRE(nodes.positions[v] < nodes.positions[mix]);
+    }
+    REQUIRE(nodes.positions[mix] < nodes.positions[reverb]);
+    REQUIRE(nodes.positions[mix] < nodes.positions[delay]);
+    REQUIRE(nodes.positions[reverb] < nodes.positions[master]);
+    REQUIRE(nodes.positions[delay] < nodes.positions[master]);
+}
+} // namespace
+
+TEST_CASE("compiled schedule is in topological order",
+          "[audio_engine|graph]")
+{
+    trace nodes{12};
+    auto schedule = voices_and_sends(nodes, 8).compile();
+    REQUIRE(schedule->size() == 12);
+
+    schedule->run(64);
+    CHECK(nodes.next == 12);
+    check_dependencies(nodes, 8);
+}
+
+TEST_CASE("graph with a cycle doesn't compile", "[audio_engine|graph]")
+{
+    bit::processing_graph graph;
+    auto a = graph.add([](size_t) {});
+    auto b = graph.add([](size_t) {});
+    auto c = graph.add([](size_t) {});
+    graph.connect(a, b);
+    graph.connect(b, c);
+    graph.connect(c, a);
+    CHECK_THROWS_AS(graph.compile(), std::runtime_error);
+    CHECK_THROWS_AS(graph.connect(a, 3), std::out_of_range);
+}
+
+TEST_CASE("executor runs every node once per block after its dependencies",
+          "[audio_engine|graph]")
+{
+    constexpr size_t voices = 32;
+    trace nodes{voices + 4};
+    auto schedule = voices_and_sends(nodes, voices).compile();
+    bit::graph_executor executor{3};
+
+    for (int block = 0; block < 1000; ++block)
+    {
+        nodes.next = 0;
+        executor.run(*schedule, 64);
+        REQUIRE(nodes.next == voices + 4);
+        check_dependencies(nodes, voices);
+    }
+}
+
+TEST_CASE("executor switches between schedules", "[audio_engine|graph]")
+{
+    trace first_nodes{6};
+    trace second_nodes{20};
+    auto first  = voices_and_sends(first_nodes, 2).compile();
+    auto second = voices_and_sends(second_nodes, 16).compile();
+    bit::graph_executor executor{2};
+
+    for (int block = 0; block < 100; ++block)
+    {
+        first_nodes.next  = 0;
+        second_nodes.next = 0;
+        executor.run(*first, 32);
+        executor.run(*second, 32);
+        REQUIRE(first_nodes.next == 6);
+        REQUIRE(second_nodes.next == 20);
+    }
+    // nothing is left running on the old schedule
+    first.reset();
+    executor.run(*second, 32);
+}
+
+TEST_CASE("executor without workers runs on the calling thread",
+          "[audio_engine|graph]")
+{
+    trace nodes{7};
+    auto schedule = voices_and_sends(nodes, 3).compile();
+    bit::graph_executor executor{0};
+    executor.run(*schedule, 16);
+    CHECK(nodes.next == 7);
+    check_dependencies(nodes, 3);
+}
+
+namespace
+{
+// a voice chain heavy enough for the spread over cores to show
+void voice_work(std::vector<float>& buffer, size_t frames)
+{
+    float phase = buffer[0];
+    for (size_t repeat = 0; repeat < 8; ++repeat)
+    {
+        for (size_t i = 0; i < frames; ++i)
+        {
+            phase     = phase + 0.01f;
+            buffer[i] = std::sin(phase) * std::cos(phase * 0.5f);
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("graph executor", "[.benchmark][audio_engine|graph]")
+{
+    constexpr size_t voices = 64;
+    constexpr size_t frames = 256;
+    std::vector<std::vector<float>> buffers(voices,
+                                            std::vector<float>(frames));
+    bit::processing_graph graph;
+    auto mix = graph.add([](size_t) {});
+    for (size_t v = 0; v < voices; ++v)
+    {
+        auto voice = graph.add(
+            [&buffer = buffers[v]](size_t n) { voice_work(buffer, n); });
+        graph.connect(voice, mix);
+    }
+    auto schedule = graph.compile();
+
+    BENCHMARK("64 voices, render thread only")
+    {
+        schedule->run(frames);
+    };
+
+    auto cores = bit::graph_executor::default_workers();
+    for (size_t workers : {size_t{1}, size_t{3}, cores})
+    {
+        bit::graph_executor executor{workers};
+        BENCHMARK("64 voices, " + std::to_string(executor.workers()) +
+                  " workers")
+        {
+            executor.run(*schedule, frames);
+        };
+    }
+}
@@ -0,0 +1,133 @@
+#include <audio_engine/loopback_backend.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// keeps the thread busy, sleeping could oversleep by a lot more
+void busy_for(std::chrono::nanoseconds duration)
+{
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until)
+    {
+    }
+}
+} // namespace
+
+TEST_CASE("simulated clock pulls blocks on the period",
+          "[audio_engine|loopback]")
+{
+    bit::loopback_backend backend{{.sampling_frequency = 48000,
+                                   .buffer_frames      = 480,
+                                   .channels           = 2,
+                                   .capture            = true}};
+    REQUIRE(backend.period() == 10'000'000);
+
+    int16_t next = 0;
+    backend.run(8, [&](std::span<int16_t> buffer) {
+        REQUIRE(buffer.size() == 960);
+        std::ranges::fill(buffer, next++);
+    });
+
+    auto timings = backend.timings();
+    REQUIRE(timings.size() == 8);
+    for (size_t block = 0; block < timings.size(); ++block)
+    {
+        const auto& timing = timings[block];
+        REQUIRE(timing.scheduled == static_cast<int64_t>(block) * 10'000'000);
+        REQUIRE(timing.started == timing.scheduled);
+        REQUIRE(timing.deadline == timing.scheduled + backend.period());
+        REQUIRE(timing.processing() >= 0);
+        REQUIRE(not timing.missed());
+    }
+    REQUIRE(backend.deadline_misses() == 0);
+
+    auto captured = backend.captured();
+    REQUIRE(captured.size() == 8 * 960);
+    REQUIRE(captured[0] == 0);
+    REQUIRE(captured[7 * 960 + 5] == 7);
+}
+
+TEST_CASE("a slow block misses its deadline and delays the next",
+          "[audio_engine|loopback]")
+{
+    using namespace std::chrono_literals;
+    // 1 ms periods
+    bit::loopback_backend backend{
+        {.sampling_frequency = 48000, .buffer_frames = 48}};
+
+    size_t block = 0;
+    backend.run(6, [&](std::span<int16_t>) {
+        if (block++ == 2)
+        {
+            busy_for(2500us);
+        }
+    });
+
+    auto timings = backend.timings();
+    REQUIRE(timings[2].missed());
+    REQUIRE(timings[2].processing() >= 2'500'000);
+    // queued behind the late block
+    REQUIRE(timings[3].started == timings[2].finished);
+    REQUIRE(timings[3].missed());
+    REQUIRE(backend.deadline_misses() >= 2);
+    REQUIRE(not timings[0].missed());
+}
+
+TEST_CASE("jitter is reproducible from the seed", "[audio_engine|loopback]")
+{
+    using namespace std::chrono_literals;
+    bit::loopback_settings settings{.buffer_frames = 64,
+                                    .jitter        = 200us,
+                                    .seed          = 7};
+    auto starts = [&](const bit::loopback_settings& with) {
+        bit::loopback_backend backend{with};
+        backend.run(64, [](std::span<int16_t>) {});
+        std::vector<int64_t> delays;
+        for (const auto& timing : backend.timings())
+        {
+            delays.push_back(timing.started - timing.scheduled);
+        }
+        return delays;
+    };
+
+    auto first = starts(settings);
+    REQUIRE(first == starts(settings));
+    REQUIRE(std::ranges::all_of(
+        first, [](int64_t delay) { return 0 <= delay and delay <= 200'000; }));
+    REQUIRE(std::ranges::count(first, first[0]) < 64);
+
+    settings.seed = 8;
+    REQUIRE(first != starts(settings));
+}
+
+TEST_CASE("realtime clock sleeps until every period",
+          "[audio_engine|loopback]")
+{
+    bit::loopback_backend backend{{.sampling_frequency = 48000,
+                                   .buffer_frames      = 96,
+                                   .clock = bit::loopback_clock::realtime}};
+    auto start = std::chrono::steady_clock::now();
+    backend.run(20, [](std::span<int16_t>) {});
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // 19 periods of 2 ms go by before the last block starts
+    REQUIRE(elapsed >= std::chrono::milliseconds{38});
+    for (const auto& timing : backend.timings())
+    {
+        REQUIRE(timing.started >= timing.scheduled);
+        REQUIRE(timing.finished >= timing.started);
+    }
+}
+
+TEST_CASE("loopback settings are validated", "[audio_engine|loopback]")
+{
+    REQUIRE_THROWS_AS(bit::loopback_backend{{.buffer_frames = 0}},
+                      std::range_error);
+    REQUIRE_THROWS_AS(bit::loopback_backend{{.sampling_frequency = 0}},
+                      std::range_error);
+}
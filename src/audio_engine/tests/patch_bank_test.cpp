@@ -0,0 +1,191 @@
+#include <audio_engine/command_queue.h>
+#include <audio_engine/patch_bank.h>
+#include <audio_engine/synth.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+using table_sample = bit::patch_bank::table_sample;
+
+std::vector<bit::stored_patch> some_patches()
+{
+    bit::patch lead;
+    lead.shape     = bit::dsp::waveform::pulse;
+    lead.attack    = 0.01;
+    lead.cutoff    = 2500;
+    lead.resonance = 2.5;
+    bit::patch crushed;
+    crushed.depth = 1;
+    crushed.hold  = 4;
+    return {bit::to_stored_patch({}, "init"),
+            bit::to_stored_patch(lead, "lead"),
+            bit::to_stored_patch(crushed, "crushed")};
+}
+
+std::vector<table_sample> some_tables(size_t tables, size_t length)
+{
+    std::vector<table_sample> samples(tables * length);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = table_sample{
+            std::sin(static_cast<double>(i % length) / length * 6.28) * 0.5};
+    }
+    return samples;
+}
+} // namespace
+
+TEST_CASE("patches keep their values through the stored layout",
+          "[audio_engine|patch_bank]")
+{
+    bit::patch sound;
+    sound.shape   = bit::dsp::waveform::triangle;
+    sound.release = 1.25;
+    sound.depth   = 6;
+    auto stored   = bit::to_stored_patch(sound, "pad");
+    REQUIRE(stored.label() == "pad");
+
+    auto restored = bit::to_patch(stored);
+    REQUIRE(restored.shape == bit::dsp::waveform::triangle);
+    REQUIRE(restored.release == 1.25);
+    REQUIRE(std::abs(restored.sustain - sound.sustain) < 1e-9);
+    REQUIRE(std::abs(restored.resonance - sound.resonance) < 1e-8);
+    REQUIRE(restored.depth == 6);
+
+    auto name = std::string(28, 'x');
+    REQUIRE(bit::to_stored_patch(sound, name).label() == name);
+    name += 'x';
+    REQUIRE_THROWS_AS(bit::to_stored_patch(sound, name), std::range_error);
+}
+
+TEST_CASE("a bank is read in place", "[audio_engine|patch_bank]")
+{
+    auto patches = some_patches();
+    auto tables  = some_tables(2, 64);
+    auto bytes   = bit::pack_patch_bank(patches, tables, 64);
+    REQUIRE(bytes.size() == 32 + 3 * 64 + 2 * 64 * 2);
+
+    bit::patch_bank bank{bytes};
+    REQUIRE(bank.patches().size() == 3);
+    REQUIRE(std::memcmp(bank.patches().data(),
+                        patches.data(),
+                        sizeof(bit::stored_patch) * 3) == 0);
+    REQUIRE(reinterpret_cast<const uint8_t*>(&bank.patch(0)) ==
+            bytes.data() + 32);
+    REQUIRE(bank.find("lead") == &bank.patch(1));
+    REQUIRE(bank.find("missing") == nullptr);
+
+    REQUIRE(bank.tables() == 2);
+    REQUIRE(bank.table(1).size() == 64);
+    REQUIRE(std::ranges::equal(bank.table(1),
+                               std::span{tables}.subspan(64, 64)));
+
+    auto empty = bit::pack_patch_bank({});
+    REQUIRE(bit::patch_bank{empty}.patches().empty());
+    REQUIRE(bit::patch_bank{empty}.tables() == 0);
+}
+
+TEST_CASE("damaged banks are rejected", "[audio_engine|patch_bank]")
+{
+    auto bytes  = bit::pack_patch_bank(some_patches(), some_tables(1, 16), 16);
+    auto reject = [](std::vector<uint8_t> damaged) {
+        REQUIRE_THROWS_AS(bit::patch_bank{damaged}, std::runtime_error);
+    };
+
+    auto magic = bytes;
+    magic[0]   = 'X';
+    reject(magic);
+
+    auto version = bytes;
+    version[4]   = 2;
+    reject(version);
+
+    auto truncated = bytes;
+    truncated.pop_back();
+    reject(truncated);
+
+    auto flipped = bytes;
+    flipped[32 + 64 + 40] ^= 0x01;
+    reject(flipped);
+
+    // a checksum doesn't make the fields valid
+    auto patches     = some_patches();
+    patches[2].shape = 7;
+    reject(bit::pack_patch_bank(patches));
+}
+
+TEST_CASE("a bank file is mapped", "[audio_engine|patch_bank]")
+{
+    auto bytes = bit::pack_patch_bank(some_patches(), some_tables(4, 256), 256);
+    auto path  = std::filesystem::temp_directory_path() /
+                "bitcrackle_patch_bank_test.bcpb";
+    {
+        std::ofstream out{path, std::ios::binary};
+        out.write(reinterpret_cast<const char*>(bytes.data()),
+                  static_cast<std::streamsize>(bytes.size()));
+    }
+
+    {
+        bit::patch_bank bank{path};
+        REQUIRE(bank.patches().size() == 3);
+        REQUIRE(bank.patch(2).label() == "crushed");
+        REQUIRE(bank.tables() == 4);
+    }
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(bit::patch_bank{path}, std::runtime_error);
+}
+
+TEST_CASE("program changes swap the synth's patch",
+          "[audio_engine|patch_bank]")
+{
+    auto bytes = bit::pack_patch_bank(some_patches());
+    bit::patch_bank bank{bytes};
+    bit::synth synth{{}, 48000, 2, 128};
+    bit::engine_command_queue queue{4};
+    std::vector<bit::synth::bus_type> left(128);
+    std::vector<bit::synth::bus_type> right(128);
+
+    REQUIRE(queue.send(bit::commands::set_program{bank.find("crushed")}));
+    queue.dispatch(
+        [&](const bit::engine_command& command) { synth.execute(command); });
+    synth.note_on(60, 127);
+    for (size_t block = 0; block < 8; ++block)
+    {
+        synth.render(128);
+    }
+    synth.mix(left, right);
+
+    // one bit leaves the sign only
+    std::ranges::sort(left);
+    auto levels = std::ranges::unique(left);
+    REQUIRE(left.size() - levels.size() <= 2);
+    REQUIRE(left.front() < left.back());
+}
+
+TEST_CASE("patch bank", "[.benchmark][audio_engine|patch_bank]")
+{
+    // 128 patches and 64 tables of 2048 samples, about 260 kB
+    std::vector<bit::stored_patch> patches(128, some_patches()[1]);
+    auto bytes = bit::pack_patch_bank(patches, some_tables(64, 2048), 2048);
+    BENCHMARK("load a bank")
+    {
+        return bit::patch_bank{bytes}.tables();
+    };
+
+    bit::patch_bank bank{bytes};
+    bit::synth synth{{}, 48000, 16, 256};
+    size_t program = 0;
+    BENCHMARK("program change")
+    {
+        synth.set_program(bank.patch(program++ % 128));
+    };
+}
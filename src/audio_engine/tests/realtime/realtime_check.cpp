@@ -0,0 +1,305 @@
+#include "realtime_check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <new>
+#include <pthread.h>
+#include <string_view>
+
+// glibc entry points behind malloc and friends, so the replacements below
+// don't have to look them up with dlsym, which allocates itself
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* pointer);
+}
+
+namespace
+{
+// frames of the checker itself, report() and the interposed call
+constexpr int skipped_frames = 2;
+
+struct slot
+{
+    std::atomic<const char*> call{nullptr};
+    size_t frames = 0;
+    std::array<void*, bit::test::violation::max_frames> stack{};
+};
+
+std::array<slot, bit::test::max_violations> slots;
+std::atomic<size_t> count{0};
+
+thread_local int depth = 0;
+// set while the checker itself allocates, e.g. the first backtrace() loading
+// the unwinder, or a checked_resource calling its upstream
+thread_local bool suspended = false;
+
+[[gnu::noinline]] void report(const char* call) noexcept
+{
+    if (depth == 0 or suspended)
+    {
+        return;
+    }
+    suspended = true;
+    auto index = count.fetch_add(1, std::memory_order_relaxed);
+    if (index < slots.size())
+    {
+        auto& found = slots[index];
+        std::array<void*, bit::test::violation::max_frames + skipped_frames>
+            stack;
+        auto frames =
+            std::max(backtrace(stack.data(), static_cast<int>(stack.size())),
+                     skipped_frames) -
+            skipped_frames;
+        std::copy_n(
+            stack.begin() + skipped_frames, frames, found.stack.begin());
+        found.frames = static_cast<size_t>(frames);
+        found.call.store(call, std::memory_order_release);
+    }
+    suspended = false;
+}
+
+class suspend_checks
+{
+    bool _previous = suspended;
+
+  public:
+    suspend_checks() noexcept
+    {
+        suspended = true;
+    }
+
+    ~suspend_checks()
+    {
+        suspended = _previous;
+    }
+};
+
+using mutex_lock_type = int (*)(pthread_mutex_t*);
+
+mutex_lock_type next_mutex_lock() noexcept
+{
+    static auto* next = [] {
+        suspend_checks suspend;
+        return reinterpret_cast<mutex_lock_type>(
+            dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    }();
+    return next;
+}
+
+// backtrace() loads libgcc_s and dlsym() allocates on their first call, get
+// both done before any section
+[[maybe_unused]] const bool checker_ready = [] {
+    std::array<void*, 1> stack;
+    return backtrace(stack.data(), 1) >= 0 and next_mutex_lock() != nullptr;
+}();
+
+std::string symbol_name(std::string_view line)
+{
+    // binary(mangled+0x1f) [0x...]
+    auto open = line.find('(');
+    auto plus = line.find('+', open);
+    if (open == std::string_view::npos or plus == std::string_view::npos or
+        plus == open + 1)
+    {
+        return std::string{line};
+    }
+    std::string mangled{line.substr(open + 1, plus - open - 1)};
+    int status      = 0;
+    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr,
+                                          &status);
+    std::string name = status == 0 ? demangled : mangled;
+    std::free(demangled);
+    return name;
+}
+} // namespace
+
+namespace bit::test
+{
+realtime_section::realtime_section() noexcept
+{
+    ++depth;
+}
+
+realtime_section::~realtime_section()
+{
+    --depth;
+}
+
+bool in_realtime_section() noexcept
+{
+    return depth > 0;
+}
+
+std::vector<violation> violations()
+{
+    std::vector<violation> found;
+    auto recorded = std::min(count.load(std::memory_order_acquire),
+                             slots.size());
+    for (size_t i = 0; i < recorded; ++i)
+    {
+        auto* call = slots[i].call.load(std::memory_order_acquire);
+        if (call == nullptr)
+        {
+            continue;
+        }
+        found.push_back({call, slots[i].frames, slots[i].stack});
+    }
+    return found;
+}
+
+size_t violation_count() noexcept
+{
+    return count.load(std::memory_order_acquire);
+}
+
+void clear_violations() noexcept
+{
+    for (auto& found : slots)
+    {
+        found.call.store(nullptr, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_release);
+}
+
+std::string describe(const std::vector<violation>& found)
+{
+    std::string description;
+    for (const auto& each : found)
+    {
+        description += each.call;
+        description += " in a real-time section\n";
+        auto frames  = static_cast<int>(each.frames);
+        auto* lines  = backtrace_symbols(each.stack.data(), frames);
+        for (int i = 0; lines != nullptr and i < frames; ++i)
+        {
+            description += "    #" + std::to_string(i) + " ";
+            description += symbol_name(lines[i]);
+            description += '\n';
+        }
+        std::free(lines);
+    }
+    if (auto total = violation_count(); total > found.size())
+    {
+        description += std::to_string(total - found.size()) +
+                       " more without a backtrace\n";
+    }
+    return description;
+}
+
+void* checked_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    report("memory_resource::allocate");
+    suspend_checks suspend;
+    return _upstream->allocate(bytes, alignment);
+}
+
+void checked_resource::do_deallocate(void* pointer,
+                                     std::size_t bytes,
+                                     std::size_t alignment)
+{
+    report("memory_resource::deallocate");
+    suspend_checks suspend;
+    _upstream->deallocate(pointer, bytes, alignment);
+}
+
+bool checked_resource::do_is_equal(const memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+} // namespace bit::test
+
+extern "C"
+{
+void* malloc(size_t size)
+{
+    report("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    report("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size)
+{
+    report("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer)
+{
+    if (pointer)
+    {
+        report("free");
+    }
+    __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    report("pthread_mutex_lock");
+    return next_mutex_lock()(mutex);
+}
+}
+
+// the array and nothrow forms of libstdc++ end up in these
+void* operator new(std::size_t size)
+{
+    report("operator new");
+    if (auto* pointer = __libc_malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    report("operator new");
+    if (auto* pointer = __libc_memalign(static_cast<size_t>(alignment),
+                                        size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer)
+    {
+        report("operator delete");
+    }
+    __libc_free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    if (pointer)
+    {
+        report("operator delete");
+    }
+    __libc_free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    ::operator delete(pointer);
+}
+
+void operator delete(void* pointer,
+                     std::size_t,
+                     std::align_val_t alignment) noexcept
+{
+    ::operator delete(pointer, alignment);
+}
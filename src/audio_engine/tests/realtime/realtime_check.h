@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Test only instrumentation of the render path. The checker interposes
+// malloc, calloc, realloc, free, the global operator new and delete, and
+// pthread_mutex_lock; any of them called on a thread inside a
+// realtime_section is recorded together with a backtrace. Memory resources
+// handed to the engine, e.g. to a ring_buffer, can be wrapped in a
+// checked_resource to be reported the same way.
+//
+// Recording doesn't allocate, the backtraces are only symbolized by
+// describe(), outside of the section.
+namespace bit::test
+{
+struct violation
+{
+    static constexpr size_t max_frames = 32;
+
+    // name of the offending call, e.g. "malloc"
+    const char* call = nullptr;
+    size_t frames    = 0;
+    std::array<void*, max_frames> stack{};
+};
+
+// Marks the scope as real-time on the current thread; sections nest.
+class realtime_section
+{
+  public:
+    realtime_section() noexcept;
+    ~realtime_section();
+
+    realtime_section(const realtime_section&)            = delete;
+    realtime_section& operator=(const realtime_section&) = delete;
+};
+
+[[nodiscard]] bool in_realtime_section() noexcept;
+
+// Violations recorded since the last clear, from every thread. Only the
+// first max_violations are kept, violation_count() tells how many there
+// were in total.
+inline constexpr size_t max_violations = 64;
+
+[[nodiscard]] std::vector<violation> violations();
+[[nodiscard]] size_t violation_count() noexcept;
+void clear_violations() noexcept;
+
+// One line per violation followed by its symbolized stack.
+[[nodiscard]] std::string describe(const std::vector<violation>& found);
+
+// Runs function inside a realtime_section and returns what it did wrong.
+template <typename FunctionT>
+[[nodiscard]] std::vector<violation> realtime_violations(FunctionT&& function)
+{
+    clear_violations();
+    {
+        realtime_section section;
+        function();
+    }
+    return violations();
+}
+
+// Forwards to upstream, reporting allocate and deallocate calls made inside
+// a realtime_section. The upstream isn't reported twice.
+class checked_resource : public std::pmr::memory_resource
+{
+    std::pmr::memory_resource* _upstream;
+
+  public:
+    explicit checked_resource(std::pmr::memory_resource* upstream =
+                                  std::pmr::get_default_resource()) noexcept
+        : _upstream{upstream}
+    {
+    }
+
+  protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer,
+                       std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const memory_resource& other) const noexcept override;
+};
+} // namespace bit::test
+
+// Checks that the statements neither allocate nor lock, printing the
+// backtraces of the calls that did.
+#define CHECK_REALTIME_SAFE(...)                                               \
+    do                                                                         \
+    {                                                                          \
+        auto realtime_found_ =                                                 \
+            bit::test::realtime_violations([&] { __VA_ARGS__; });              \
+        INFO(bit::test::describe(realtime_found_));                            \
+        CHECK(realtime_found_.empty());                                        \
+    } while (false)
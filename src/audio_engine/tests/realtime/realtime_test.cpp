@@ -0,0 +1,218 @@
+#include "realtime_check.h"
+
+#include <audio_engine/command_queue.h>
+#include <audio_engine/graph.h>
+#include <audio_engine/graph_executor.h>
+#include <audio_engine/ring_buffer.h>
+#include <audio_engine/spsc_queue.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <ranges>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace
+{
+bool reported(const std::vector<bit::test::violation>& found,
+              std::string_view call)
+{
+    return std::ranges::any_of(found, [&](const auto& each) {
+        return each.call == call and each.frames > 0;
+    });
+}
+
+} // namespace
+
+// not in the anonymous namespace, so that the backtrace can name it
+[[gnu::noinline]] void allocate_in_callback();
+
+void allocate_in_callback()
+{
+    // volatile, so that the allocation can't be elided
+    int* volatile allocated = new int{};
+    delete allocated;
+}
+
+TEST_CASE("checker reports allocations, frees and locks in a section",
+          "[realtime|check]")
+{
+    std::mutex mutex;
+    auto found = bit::test::realtime_violations([&] {
+        allocate_in_callback();
+        void* volatile raw = std::malloc(16);
+        std::free(raw);
+        std::scoped_lock lock{mutex};
+    });
+
+    CHECK(reported(found, "operator new"));
+    CHECK(reported(found, "operator delete"));
+    CHECK(reported(found, "malloc"));
+    CHECK(reported(found, "free"));
+    CHECK(reported(found, "pthread_mutex_lock"));
+    CHECK(found.size() == 5);
+    // the backtrace goes through the function that allocated
+    auto description = bit::test::describe(found);
+    CHECK(description.find("allocate_in_callback") != std::string::npos);
+}
+
+TEST_CASE("checker ignores code outside of sections", "[realtime|check]")
+{
+    bit::test::clear_violations();
+    {
+        bit::test::realtime_section section;
+    }
+    auto owned = std::make_unique<int>(1);
+    std::mutex mutex;
+    std::scoped_lock lock{mutex};
+    CHECK(bit::test::violations().empty());
+    CHECK_FALSE(bit::test::in_realtime_section());
+}
+
+TEST_CASE("checker follows the thread that entered the section",
+          "[realtime|check]")
+{
+    std::atomic<int> stage{0};
+    std::jthread render{[&] {
+        bit::test::realtime_section section;
+        stage = 1;
+        while (stage != 2)
+        {
+        }
+    }};
+    while (stage != 1)
+    {
+    }
+    bit::test::clear_violations();
+    auto owned = std::make_unique<int>(1);
+    stage      = 2;
+    render.join();
+    CHECK(bit::test::violation_count() == 0);
+}
+
+TEST_CASE("checked_resource reports allocations in a section",
+          "[realtime|check]")
+{
+    bit::test::checked_resource resource;
+    std::pmr::polymorphic_allocator<int> allocator{&resource};
+    auto found = bit::test::realtime_violations([&] {
+        auto* values = allocator.allocate(8);
+        allocator.deallocate(values, 8);
+    });
+
+    // without the operator new and delete behind the resource
+    REQUIRE(found.size() == 2);
+    CHECK(reported(found, "memory_resource::allocate"));
+    CHECK(reported(found, "memory_resource::deallocate"));
+}
+
+TEST_CASE("ring_buffer push and iteration are real-time safe",
+          "[realtime|ring_buffer]")
+{
+    bit::test::checked_resource resource;
+    bit::ring_buffer<int> ring(64, alignof(int), &resource);
+    std::array<int, 48> block{};
+    std::iota(block.begin(), block.end(), 0);
+    int sum = 0;
+
+    CHECK_REALTIME_SAFE(for (int i = 0; i < 10; ++i) {
+        ring.push(block);
+        sum = 0;
+        for (int value : ring)
+        {
+            sum += value;
+        }
+    });
+    CHECK(ring.size() == 64);
+    CHECK(sum > 0);
+}
+
+TEST_CASE("ring_buffer created on the render path is reported",
+          "[realtime|ring_buffer]")
+{
+    bit::test::checked_resource resource;
+    auto found = bit::test::realtime_violations([&] {
+        bit::ring_buffer<int> ring(64, alignof(int), &resource);
+    });
+
+    CHECK(reported(found, "memory_resource::allocate"));
+    CHECK(reported(found, "memory_resource::deallocate"));
+}
+
+TEST_CASE("spsc_queue push and pop are real-time safe",
+          "[realtime|spsc_queue]")
+{
+    bit::spsc_queue<int> queue(16);
+    int sum = 0;
+
+    CHECK_REALTIME_SAFE(for (int i = 0; i < 1000; ++i) {
+        (void)queue.push(i);
+        sum += queue.pop().value_or(0);
+    });
+    CHECK(sum == 999 * 1000 / 2);
+}
+
+TEST_CASE("command_queue dispatch and retire are real-time safe",
+          "[realtime|command_queue]")
+{
+    bit::engine_command_queue queue{64};
+    float hertz   = 0;
+    auto* current = new int{0};
+    int destroyed = 0;
+
+    for (int block = 1; block <= 100; ++block)
+    {
+        auto replacement = bit::retire(new int{block});
+        REQUIRE(queue.send(bit::commands::swap_object{
+            0, replacement.object, replacement.destroy}));
+        REQUIRE(queue.send(
+            bit::commands::set_frequency{static_cast<float>(block)}));
+
+        CHECK_REALTIME_SAFE(queue.dispatch([&](const auto& command) {
+            if (auto* swap = std::get_if<bit::commands::swap_object>(&command))
+            {
+                (void)queue.retire(bit::retire(current));
+                current = static_cast<int*>(swap->object);
+            }
+            else if (auto* frequency =
+                         std::get_if<bit::commands::set_frequency>(&command))
+            {
+                hertz = frequency->hertz;
+            }
+        }));
+        destroyed += static_cast<int>(queue.collect());
+    }
+
+    CHECK(hertz == 100.0f);
+    CHECK(*current == 100);
+    CHECK(destroyed == 100);
+    delete current;
+}
+
+TEST_CASE("graph_executor runs a block without allocating or locking",
+          "[realtime|graph]")
+{
+    std::array<std::atomic<int>, 16> runs{};
+    bit::processing_graph graph;
+    auto master = graph.add([&](size_t) { ++runs[15]; });
+    for (size_t n = 0; n < 15; ++n)
+    {
+        auto voice = graph.add([&, n](size_t) { ++runs[n]; });
+        graph.connect(voice, master);
+    }
+    auto schedule = graph.compile();
+    bit::graph_executor executor{2};
+
+    CHECK_REALTIME_SAFE(for (int block = 0; block < 100; ++block) {
+        executor.run(*schedule, 64);
+    });
+    CHECK(std::ranges::all_of(runs, [](const auto& n) { return n == 100; }));
+}
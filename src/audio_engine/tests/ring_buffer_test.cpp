@@ -1,10 +1,14 @@
 #include <audio_engine/ring_buffer.h>
 
 #include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_range_equals.hpp>
 #include <memory_resource>
+#include <numeric>
 #include <ranges>
+#include <stdexcept>
+#include <vector>
 
 TEST_CASE("Default constructed ring_buffer is empty with 0 capacity",
           "[audio_engine|ring_buffer]")
@@ -102,3 +106,98 @@ SCENARIO("adding elements to ring_buffer", "[audio_engine|ring_buffer]")
         }
     }
 }
+
+TEST_CASE("power of two ring_buffer takes only powers of two",
+          "[audio_engine|ring_buffer]")
+{
+    using ring_type = bit::ring_buffer<int, bit::power_of_two_capacity>;
+    REQUIRE_THROWS_AS(ring_type(24), std::range_error);
+
+    ring_type ring(16);
+    REQUIRE(ring.capacity() == 16);
+    ring.push(std::views::iota(0, 40));
+    ranges_equal(ring, std::views::iota(24, 40));
+    ring.push(std::views::iota(40, 45));
+    ranges_equal(ring, std::views::iota(29, 45));
+}
+
+TEST_CASE("ring_buffer keeps the last values of unsized ranges",
+          "[audio_engine|ring_buffer]")
+{
+    bit::ring_buffer<int> ring(10);
+    auto even = std::views::iota(0, 40) |
+                std::views::filter([](int value) { return value % 2 == 0; });
+    ring.push(even);
+    auto doubled = [](int value) { return value * 2; };
+    ranges_equal(ring,
+                 std::views::iota(10, 20) | std::views::transform(doubled));
+}
+
+TEST_CASE("ring_buffer segments are its values in order",
+          "[audio_engine|ring_buffer]")
+{
+    bit::ring_buffer<int, bit::power_of_two_capacity> ring(8);
+    REQUIRE(ring.segments()[0].empty());
+    REQUIRE(ring.segments()[1].empty());
+
+    ring.push(std::views::iota(0, 5));
+    REQUIRE(ring.segments()[0].size() == 5);
+    REQUIRE(ring.segments()[1].empty());
+
+    ring.push(std::views::iota(5, 11));
+    const auto& wrapped = ring;
+    auto [first, second] = wrapped.segments();
+    REQUIRE(first.size() == 5);
+    REQUIRE(second.size() == 3);
+
+    std::vector<int> copied;
+    for (auto segment : wrapped.segments())
+    {
+        std::ranges::copy(segment, std::back_inserter(copied));
+    }
+    ranges_equal(copied, std::views::iota(3, 11));
+    ranges_equal(copied, ring);
+}
+
+TEST_CASE("ring_buffer", "[.benchmark][audio_engine|ring_buffer]")
+{
+    std::vector<int> block(256);
+    std::iota(block.begin(), block.end(), 0);
+    bit::ring_buffer<int> any(1024);
+    bit::ring_buffer<int, bit::power_of_two_capacity> masked(1024);
+    // wraps around the end of the storage every fourth push
+    any.push(std::views::iota(0, 100));
+    masked.push(std::views::iota(0, 100));
+
+    BENCHMARK("push 256 values, any capacity")
+    {
+        any.push(block);
+        return any.size();
+    };
+    BENCHMARK("push 256 values, power of two capacity")
+    {
+        masked.push(block);
+        return masked.size();
+    };
+
+    auto sum = [](const auto& range) {
+        return std::accumulate(range.begin(), range.end(), int64_t{});
+    };
+    BENCHMARK("iterate 1024 values, any capacity")
+    {
+        return sum(any);
+    };
+    BENCHMARK("iterate 1024 values, power of two capacity")
+    {
+        return sum(masked);
+    };
+    BENCHMARK("iterate 1024 values by segments")
+    {
+        int64_t total = 0;
+        for (auto segment : masked.segments())
+        {
+            total += sum(segment);
+        }
+        return total;
+    };
+}
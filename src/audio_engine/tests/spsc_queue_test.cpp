@@ -0,0 +1,107 @@
+#include <audio_engine/spsc_queue.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <thread>
+
+TEST_CASE("spsc_queue rounds its capacity up to a power of two",
+          "[audio_engine|spsc_queue]")
+{
+    bit::spsc_queue<int> queue(10);
+    CHECK(queue.capacity() == 16);
+    CHECK(queue.empty());
+}
+
+TEST_CASE("spsc_queue is first in, first out and bounded",
+          "[audio_engine|spsc_queue]")
+{
+    bit::spsc_queue<int> queue(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        REQUIRE(queue.push(i));
+    }
+    CHECK_FALSE(queue.push(4));
+    CHECK(queue.size() == 4);
+
+    CHECK(queue.pop() == 0);
+    CHECK(queue.push(4));
+    for (int i = 1; i <= 4; ++i)
+    {
+        REQUIRE(queue.pop() == i);
+    }
+    CHECK_FALSE(queue.pop().has_value());
+}
+
+namespace
+{
+class counting_resource : public std::pmr::memory_resource
+{
+  public:
+    size_t allocations{};
+
+  protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer,
+                       std::size_t bytes,
+                       std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+} // namespace
+
+TEST_CASE("spsc_queue allocates only at construction",
+          "[audio_engine|spsc_queue]")
+{
+    counting_resource resource;
+    bit::spsc_queue<int64_t> queue(64, &resource);
+    CHECK(resource.allocations == 1);
+
+    for (int64_t i = 0; i < 1000; ++i)
+    {
+        REQUIRE(queue.push(i));
+        REQUIRE(queue.pop() == i);
+    }
+    CHECK(resource.allocations == 1);
+}
+
+TEST_CASE("spsc_queue hands values between two threads in order",
+          "[audio_engine|spsc_queue]")
+{
+    constexpr uint64_t count = 1'000'000;
+    bit::spsc_queue<uint64_t> queue(256);
+
+    std::jthread producer{[&] {
+        for (uint64_t i = 0; i < count;)
+        {
+            if (queue.push(i))
+            {
+                ++i;
+            }
+        }
+    }};
+
+    uint64_t expected = 0;
+    bool ordered      = true;
+    while (expected < count)
+    {
+        if (auto value = queue.pop())
+        {
+            ordered = ordered and *value == expected;
+            ++expected;
+        }
+    }
+    CHECK(ordered);
+    CHECK(queue.empty());
+}
@@ -0,0 +1,146 @@
+#include <audio_engine/command_queue.h>
+#include <audio_engine/synth.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+constexpr double sampling_frequency = 48000;
+constexpr size_t block              = 128;
+using bus_type                      = bit::synth::bus_type;
+
+struct output
+{
+    std::vector<bus_type> left  = std::vector<bus_type>(block);
+    std::vector<bus_type> right = std::vector<bus_type>(block);
+
+    // of both channels, in raw units
+    int64_t peak() const
+    {
+        int64_t peak = 0;
+        for (size_t i = 0; i < block; ++i)
+        {
+            peak = std::max({peak,
+                             std::abs(int64_t{left[i].raw()}),
+                             std::abs(int64_t{right[i].raw()})});
+        }
+        return peak;
+    }
+};
+
+int64_t play(bit::synth& synth, output& out, size_t blocks)
+{
+    int64_t peak = 0;
+    for (size_t b = 0; b < blocks; ++b)
+    {
+        synth.render(block);
+        synth.mix(out.left, out.right);
+        peak = std::max(peak, out.peak());
+    }
+    return peak;
+}
+} // namespace
+
+TEST_CASE("a note sounds until its release ends", "[audio_engine|synth]")
+{
+    bit::patch sound;
+    sound.release = 0.01;
+    bit::synth synth{sound, sampling_frequency, 4, block};
+    output out;
+
+    REQUIRE(play(synth, out, 4) == 0);
+    REQUIRE(synth.active_voices() == 0);
+
+    synth.note_on(69, 127);
+    REQUIRE(synth.active_voices() == 1);
+    REQUIRE(play(synth, out, 8) > 0);
+    REQUIRE(out.left == out.right);
+
+    synth.note_off(69);
+    // 10 ms is 480 frames
+    play(synth, out, 5);
+    REQUIRE(synth.active_voices() == 0);
+    REQUIRE(play(synth, out, 2) == 0);
+}
+
+TEST_CASE("velocity scales the voice", "[audio_engine|synth]")
+{
+    bit::patch sound;
+    bit::synth loud{sound, sampling_frequency, 1, block};
+    bit::synth quiet{sound, sampling_frequency, 1, block};
+    output out;
+
+    loud.note_on(60, 127);
+    quiet.note_on(60, 32);
+    auto loud_peak  = play(loud, out, 16);
+    auto quiet_peak = play(quiet, out, 16);
+    REQUIRE(quiet_peak > 0);
+    REQUIRE(quiet_peak < loud_peak / 2);
+}
+
+TEST_CASE("notes steal the oldest voice", "[audio_engine|synth]")
+{
+    bit::patch sound;
+    sound.release = 0.02;
+    bit::synth synth{sound, sampling_frequency, 2, block};
+    output out;
+
+    synth.note_on(60, 100);
+    synth.note_on(64, 100);
+    synth.note_on(67, 100);
+    REQUIRE(synth.active_voices() == 2);
+    play(synth, out, 2);
+
+    // 60 was stolen, so only 67 keeps sounding besides 64
+    synth.note_off(60);
+    synth.note_off(64);
+    play(synth, out, 40);
+    REQUIRE(synth.active_voices() == 1);
+
+    // retriggering a sounding note reuses its voice
+    synth.note_on(67, 100);
+    REQUIRE(synth.active_voices() == 1);
+    synth.all_notes_off();
+    play(synth, out, 40);
+    REQUIRE(synth.active_voices() == 0);
+}
+
+TEST_CASE("gain and cutoff commands glide instead of stepping",
+          "[audio_engine|synth]")
+{
+    bit::patch sound;
+    sound.smoothing = 0.01;
+    bit::synth synth{sound, sampling_frequency, 4, block};
+    bit::engine_command_queue queue{16};
+    output out;
+    auto execute = [&](const bit::engine_command& command) {
+        synth.execute(command);
+    };
+
+    synth.note_on(69, 127);
+    play(synth, out, 16);
+    auto loud = play(synth, out, 1);
+
+    REQUIRE(queue.send(bit::commands::set_gain{0.25f}));
+    REQUIRE(queue.send(bit::commands::set_cutoff{500.0f}));
+    REQUIRE(queue.dispatch(execute) == 2);
+    // the first block after still near the old gain
+    auto ramping = play(synth, out, 1);
+    play(synth, out, 8);
+    auto quiet = play(synth, out, 1);
+    REQUIRE(quiet > 0);
+    REQUIRE(quiet < loud / 4);
+    REQUIRE(ramping > quiet);
+
+    REQUIRE(queue.send(bit::commands::set_gain{1.0f}));
+    REQUIRE(queue.send(bit::commands::set_bit_depth{1}));
+    queue.dispatch(execute);
+    play(synth, out, 16);
+    // one bit leaves the sign only
+    std::ranges::sort(out.left);
+    auto levels = std::ranges::unique(out.left);
+    REQUIRE(out.left.size() - levels.size() <= 2);
+}
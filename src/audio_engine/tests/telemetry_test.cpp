@@ -0,0 +1,152 @@
+#include <audio_engine/telemetry.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("histogram buckets are within an eighth", "[audio_engine|telemetry]")
+{
+    for (uint64_t value : {0, 1, 7, 8, 9, 15, 16, 17, 100, 1000, 123'456})
+    {
+        auto bucket = bit::histogram::bucket(value);
+        REQUIRE(bit::histogram::lowest(bucket) <= value);
+        REQUIRE(value < bit::histogram::lowest(bucket + 1));
+        REQUIRE(value - bit::histogram::lowest(bucket) <= value / 8);
+    }
+    REQUIRE(bit::histogram::bucket(~uint64_t{}) ==
+            bit::histogram::buckets - 1);
+}
+
+TEST_CASE("percentiles come from the buckets", "[audio_engine|telemetry]")
+{
+    bit::histogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.record(value);
+    }
+    bit::histogram::counts counts;
+    histogram.copy(counts);
+    auto summary = bit::summarize(counts, histogram.max());
+
+    REQUIRE(summary.count == 1000);
+    REQUIRE(summary.max == 1000);
+    REQUIRE(summary.p50 >= 500 * 7 / 8);
+    REQUIRE(summary.p50 <= 500 * 9 / 8);
+    REQUIRE(summary.p99 >= 990 * 7 / 8);
+    REQUIRE(summary.p99 <= 1000);
+
+    bit::histogram::counts empty{};
+    REQUIRE(bit::summarize(empty, 0).count == 0);
+}
+
+TEST_CASE("telemetry totals blocks, xruns, queues and voices",
+          "[audio_engine|telemetry]")
+{
+    bit::engine_telemetry telemetry;
+    for (int block = 0; block < 99; ++block)
+    {
+        telemetry.record_block(500us, 1ms);
+    }
+    telemetry.record_block(1500us, 1ms);
+    telemetry.record_xrun();
+    telemetry.record_queue_depth(12);
+    telemetry.record_queue_depth(3);
+    telemetry.record_voices(9);
+    telemetry.record_voices(4);
+
+    auto snapshot = telemetry.snapshot();
+    REQUIRE(snapshot.blocks == 100);
+    REQUIRE(snapshot.xruns == 1);
+    REQUIRE(snapshot.overruns == 1);
+    REQUIRE(snapshot.deadline == 1'000'000);
+    REQUIRE(snapshot.processing.count == 100);
+    REQUIRE(snapshot.processing.p50 >= 500'000 * 7 / 8);
+    REQUIRE(snapshot.processing.p50 <= 500'000 * 9 / 8);
+    REQUIRE(snapshot.processing.max == 1'500'000);
+    REQUIRE(snapshot.load_p50 >= 0.4);
+    REQUIRE(snapshot.load_p50 <= 0.6);
+    REQUIRE(snapshot.load_max == 1.5);
+    REQUIRE(snapshot.queue_depth == 3);
+    REQUIRE(snapshot.max_queue_depth == 12);
+    REQUIRE(snapshot.voices == 4);
+    REQUIRE(snapshot.max_voices == 9);
+
+    auto json = bit::to_json(snapshot);
+    REQUIRE(json.starts_with(R"({"blocks":100,"xruns":1,"overruns":1,)"));
+    REQUIRE(json.find(R"("max":1500000})") != std::string::npos);
+    REQUIRE(json.find(R"("max":1.5000})") != std::string::npos);
+    REQUIRE(json.ends_with(R"("voices":4,"max_voices":9})"));
+}
+
+TEST_CASE("the monitor reports the last interval", "[audio_engine|telemetry]")
+{
+    bit::engine_telemetry telemetry;
+    bit::telemetry_monitor monitor{telemetry};
+    for (int block = 0; block < 10; ++block)
+    {
+        telemetry.record_block(900us, 1ms);
+    }
+    auto first = monitor.poll();
+    REQUIRE(first.blocks == 10);
+    REQUIRE(first.processing.p99 >= 900'000 * 7 / 8);
+
+    for (int block = 0; block < 10; ++block)
+    {
+        telemetry.record_block(100us, 1ms);
+    }
+    auto second = monitor.poll();
+    REQUIRE(second.blocks == 10);
+    REQUIRE(second.processing.count == 10);
+    REQUIRE(second.processing.max <= 100'000 * 9 / 8);
+    REQUIRE(second.load_max < 0.2);
+
+    auto idle = monitor.poll();
+    REQUIRE(idle.blocks == 0);
+    REQUIRE(idle.processing.count == 0);
+    REQUIRE(telemetry.snapshot().blocks == 20);
+}
+
+TEST_CASE("snapshots run alongside the render thread",
+          "[audio_engine|telemetry]")
+{
+    bit::engine_telemetry telemetry;
+    std::atomic<bool> done{false};
+    std::jthread render{[&] {
+        for (size_t block = 0; block < 100'000; ++block)
+        {
+            auto timer = telemetry.time_block(1ms);
+            telemetry.record_voices(block % 16);
+        }
+        done = true;
+    }};
+
+    bit::telemetry_monitor monitor{telemetry};
+    uint64_t blocks = 0;
+    while (not done)
+    {
+        blocks += monitor.poll().blocks;
+    }
+    render.join();
+    blocks += monitor.poll().blocks;
+    REQUIRE(blocks == 100'000);
+    REQUIRE(telemetry.snapshot().max_voices == 15);
+}
+
+TEST_CASE("telemetry", "[.benchmark][audio_engine|telemetry]")
+{
+    bit::engine_telemetry telemetry;
+    BENCHMARK("timed block with a voice count")
+    {
+        auto timer = telemetry.time_block(1333us);
+        telemetry.record_voices(8);
+    };
+    BENCHMARK("snapshot")
+    {
+        return telemetry.snapshot();
+    };
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "math/accumulator.h"
+#include "math/qnumber.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <numbers>
+#include <span>
+
+#pragma warning(push)
+#pragma warning(disable : 5045)
+#include <gcem.hpp>
+#pragma warning(pop)
+
+namespace bit::dsp
+{
+// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+template <qformatted CoeffQ> struct biquad_coefficients
+{
+    CoeffQ b0{};
+    CoeffQ b1{};
+    CoeffQ b2{};
+    CoeffQ a1{};
+    CoeffQ a2{};
+};
+
+namespace detail
+{
+template <qformatted CoeffQ>
+constexpr biquad_coefficients<CoeffQ> normalized(
+    double b0, double b1, double b2, double a0, double a1, double a2)
+{
+    return {CoeffQ{b0 / a0},
+            CoeffQ{b1 / a0},
+            CoeffQ{b2 / a0},
+            CoeffQ{a1 / a0},
+            CoeffQ{a2 / a0}};
+}
+} // namespace detail
+
+// Audio EQ cookbook designs, cutoff relative to the sampling frequency
+template <qformatted CoeffQ>
+constexpr biquad_coefficients<CoeffQ> lowpass_biquad(
+    double cutoff, double q = std::numbers::sqrt2 / 2)
+{
+    assert(0 < cutoff and cutoff < 0.5);
+    auto w0     = 2 * std::numbers::pi * cutoff;
+    auto cosine = gcem::cos(w0);
+    auto alpha  = gcem::sin(w0) / (2 * q);
+    return detail::normalized<CoeffQ>((1 - cosine) / 2,
+                                      1 - cosine,
+                                      (1 - cosine) / 2,
+                                      1 + alpha,
+                                      -2 * cosine,
+                                      1 - alpha);
+}
+
+template <qformatted CoeffQ>
+constexpr biquad_coefficients<CoeffQ> highpass_biquad(
+    double cutoff, double q = std::numbers::sqrt2 / 2)
+{
+    assert(0 < cutoff and cutoff < 0.5);
+    auto w0     = 2 * std::numbers::pi * cutoff;
+    auto cosine = gcem::cos(w0);
+    auto alpha  = gcem::sin(w0) / (2 * q);
+    return detail::normalized<CoeffQ>((1 + cosine) / 2,
+                                      -(1 + cosine),
+                                      (1 + cosine) / 2,
+                                      1 + alpha,
+                                      -2 * cosine,
+                                      1 - alpha);
+}
+
+// Sections second order filters in series, direct form I. Each output is
+// summed at full product precision and the bits dropped when narrowing it
+// back into SampleQ are fed into the next sum (first order error feedback),
+// which puts the quantization noise zero at DC and keeps low cutoff sections
+// with short coefficients from drifting or limit cycling.
+//
+// Block processing loads one section's state into locals, runs the whole
+// block through it and stores it back, so the state lives in registers.
+template <qformatted CoeffQ,
+          qformatted SampleQ,
+          size_t Sections,
+          bool ErrorFeedback = true>
+    requires(Sections > 0 and CoeffQ::is_signed and SampleQ::is_signed)
+class biquad_cascade
+{
+  public:
+    using coefficient_type  = CoeffQ;
+    using sample_type       = SampleQ;
+    using coefficients_type = biquad_coefficients<CoeffQ>;
+
+    static constexpr size_t sections = Sections;
+
+  private:
+    // five terms and the fed back error
+    using accumulator_type = product_accumulator<CoeffQ, SampleQ, 3>;
+    using error_type       = qs<0, accumulator_type::fraction_bits>;
+
+    static constexpr size_t dropped_bits = CoeffQ::fraction_bits;
+    static constexpr auto error_mask =
+        static_cast<typename error_type::value_type>((1ull << dropped_bits) -
+                                                     1);
+
+    struct state
+    {
+        SampleQ x1{};
+        SampleQ x2{};
+        SampleQ y1{};
+        SampleQ y2{};
+        error_type error{};
+    };
+
+    std::array<coefficients_type, Sections> _coefficients{};
+    std::array<state, Sections> _states{};
+
+  public:
+    constexpr biquad_cascade() = default;
+
+    constexpr explicit biquad_cascade(
+        const std::array<coefficients_type, Sections>& coefficients)
+        : _coefficients(coefficients)
+    {
+    }
+
+    constexpr void set_coefficients(
+        const std::array<coefficients_type, Sections>& coefficients) noexcept
+    {
+        _coefficients = coefficients;
+    }
+
+    constexpr void reset() noexcept
+    {
+        _states.fill(state{});
+    }
+
+    // filters the block in place
+    constexpr void process(std::span<SampleQ> block) noexcept
+    {
+        for (size_t s = 0; s < Sections; ++s)
+        {
+            const auto b0 = _coefficients[s].b0;
+            const auto b1 = _coefficients[s].b1;
+            const auto b2 = _coefficients[s].b2;
+            const auto a1 = _coefficients[s].a1;
+            const auto a2 = _coefficients[s].a2;
+            auto [x1, x2, y1, y2, error] = _states[s];
+
+            for (auto& sample : block)
+            {
+                auto sum = [&] {
+                    if constexpr (ErrorFeedback)
+                    {
+                        return accumulator_type{error};
+                    }
+                    else
+                    {
+                        return accumulator_type{};
+                    }
+                }();
+                sum.mac(b0, sample);
+                sum.mac(b1, x1);
+                sum.mac(b2, x2);
+                sum.msu(a1, y1);
+                sum.msu(a2, y2);
+
+                x2 = x1;
+                x1 = sample;
+                y2 = y1;
+                y1 = sum.template narrow_as<SampleQ>();
+                // remainder of the arithmetic shift in narrow_as, always >= 0
+                error = as_is_t{static_cast<typename error_type::value_type>(
+                    sum.value().raw() & error_mask)};
+                sample = y1;
+            }
+            _states[s] = {x1, x2, y1, y2, error};
+        }
+    }
+};
+} // namespace bit::dsp
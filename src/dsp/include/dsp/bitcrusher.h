@@ -0,0 +1,236 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace bit::dsp
+{
+enum class crush_mode
+{
+    mask,  // drops the low bits, rounds towards -inf
+    round, // rounds to the nearest level, saturates at the top one
+};
+
+// Bit depth and sample rate reduction working in place on the raw containers
+// of a block.
+//
+// The depth counts the bits kept, sign included, so 2^depth levels remain. A
+// new depth is reached at the end of the next block: the block is split into
+// runs of equal depth stepping towards it, and every run is a plain masking
+// loop over the raw values, so modulating the depth costs a handful of loop
+// restarts per block instead of a per-sample dispatch.
+//
+// Sample and hold repeats one crushed sample for hold() samples; jitter()
+// randomly lengthens or shortens every held period by up to that many
+// samples, like an unstable clock of a cheap converter.
+template <qformatted SampleQ> class bitcrusher
+{
+  public:
+    using sample_type = SampleQ;
+
+    static constexpr size_t max_depth = SampleQ::bits + SampleQ::is_signed;
+
+  private:
+    using value_type = typename SampleQ::value_type;
+
+    size_t _depth;
+    size_t _target_depth;
+    crush_mode _mode;
+    size_t _hold;
+    size_t _jitter      = 0;
+    size_t _remaining   = 0;
+    value_type _held    = 0;
+    uint32_t _generator = 0x9E37'79B9;
+
+    template <crush_mode Mode>
+    [[nodiscard]] static constexpr value_type crush(value_type raw,
+                                                    value_type mask,
+                                                    value_type half,
+                                                    value_type top) noexcept
+    {
+        auto masked = static_cast<value_type>(raw & mask);
+        if constexpr (Mode == crush_mode::round)
+        {
+            // half is 0 when nothing is dropped
+            auto step = static_cast<value_type>(half << 1);
+            auto up   = (raw & half) != 0 and masked < top;
+            masked    = static_cast<value_type>(up ? masked + step : masked);
+        }
+        return masked;
+    }
+
+    struct crush_constants
+    {
+        value_type mask;
+        value_type half;
+        value_type top;
+    };
+
+    [[nodiscard]] static constexpr crush_constants constants_for(
+        size_t depth) noexcept
+    {
+        auto dropped = max_depth - depth;
+        auto mask    = static_cast<value_type>(~value_type{0} << dropped);
+        auto half    = static_cast<value_type>(
+            dropped == 0 ? 0 : value_type{1} << (dropped - 1));
+        auto top = static_cast<value_type>(
+            std::numeric_limits<SampleQ>::max().raw() & mask);
+        return {mask, half, top};
+    }
+
+    template <crush_mode Mode>
+    static constexpr void crush_run(std::span<SampleQ> run,
+                                    crush_constants constants) noexcept
+    {
+        auto [mask, half, top] = constants;
+        for (auto& sample : run)
+        {
+            sample = {as_is_t{crush<Mode>(sample.raw(), mask, half, top)}};
+        }
+    }
+
+    template <crush_mode Mode>
+    constexpr void hold_run(std::span<SampleQ> run,
+                            crush_constants constants) noexcept
+    {
+        auto [mask, half, top] = constants;
+        size_t index           = 0;
+        while (index < run.size())
+        {
+            if (_remaining == 0)
+            {
+                _held      = crush<Mode>(run[index].raw(), mask, half, top);
+                _remaining = next_hold();
+            }
+            auto end = std::min(index + _remaining, run.size());
+            _remaining -= end - index;
+            for (; index < end; ++index)
+            {
+                run[index] = {as_is_t{_held}};
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr size_t next_hold() noexcept
+    {
+        if (_jitter == 0)
+        {
+            return _hold;
+        }
+        // xorshift32
+        _generator ^= _generator << 13;
+        _generator ^= _generator >> 17;
+        _generator ^= _generator << 5;
+        auto offset = static_cast<size_t>(_generator % (2 * _jitter + 1));
+        return std::max<size_t>(_hold + offset, _jitter + 1) - _jitter;
+    }
+
+    template <crush_mode Mode>
+    constexpr void process_runs(std::span<SampleQ> block) noexcept
+    {
+        auto holding = _hold > 1 or _jitter > 0 or _remaining > 0;
+        auto rising  = _depth < _target_depth;
+        auto steps   = rising ? _target_depth - _depth : _depth - _target_depth;
+        size_t begin = 0;
+        for (size_t step = 0; step <= steps; ++step)
+        {
+            // run of the samples with index * (steps + 1) / size == step
+            auto end = ((step + 1) * block.size() + steps) / (steps + 1);
+            auto run = block.subspan(begin, end - begin);
+            auto constants =
+                constants_for(rising ? _depth + step : _depth - step);
+            if (holding)
+            {
+                hold_run<Mode>(run, constants);
+            }
+            else
+            {
+                crush_run<Mode>(run, constants);
+            }
+            begin = end;
+        }
+    }
+
+  public:
+    constexpr explicit bitcrusher(size_t depth    = max_depth,
+                                  size_t hold     = 1,
+                                  crush_mode mode = crush_mode::mask)
+        : _depth{depth}, _target_depth{depth}, _mode{mode}, _hold{hold}
+    {
+        assert(0 < depth and depth <= max_depth);
+        assert(hold > 0);
+    }
+
+    // reached at the end of the next processed block
+    constexpr void set_depth(size_t depth) noexcept
+    {
+        assert(0 < depth and depth <= max_depth);
+        _target_depth = depth;
+    }
+
+    constexpr void set_mode(crush_mode mode) noexcept
+    {
+        _mode = mode;
+    }
+
+    // takes effect when the current held sample runs out
+    constexpr void set_hold(size_t hold) noexcept
+    {
+        assert(hold > 0);
+        _hold = hold;
+    }
+
+    constexpr void set_jitter(size_t samples,
+                              uint32_t seed = 0x9E37'79B9) noexcept
+    {
+        assert(seed != 0);
+        _jitter    = samples;
+        _generator = seed;
+    }
+
+    [[nodiscard]] constexpr size_t depth() const noexcept
+    {
+        return _target_depth;
+    }
+
+    [[nodiscard]] constexpr size_t hold() const noexcept
+    {
+        return _hold;
+    }
+
+    [[nodiscard]] constexpr size_t jitter() const noexcept
+    {
+        return _jitter;
+    }
+
+    constexpr void reset() noexcept
+    {
+        _depth     = _target_depth;
+        _remaining = 0;
+        _held      = 0;
+    }
+
+    constexpr void process(std::span<SampleQ> block) noexcept
+    {
+        if (block.empty())
+        {
+            return;
+        }
+        if (_mode == crush_mode::round)
+        {
+            process_runs<crush_mode::round>(block);
+        }
+        else
+        {
+            process_runs<crush_mode::mask>(block);
+        }
+        _depth = _target_depth;
+    }
+};
+} // namespace bit::dsp
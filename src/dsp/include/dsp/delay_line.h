@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace bit::dsp
+{
+// History of the last Length samples, newest first. Every sample is stored
+// twice, Length elements apart, so the window is always one contiguous span
+// and a dot product over it never has to wrap around.
+template <typename T, size_t Length>
+    requires(Length > 0)
+class delay_line
+{
+  private:
+    std::array<T, 2 * Length> _samples{};
+    size_t _position = 0;
+
+  public:
+    static constexpr size_t length = Length;
+
+    constexpr void push(T sample) noexcept
+    {
+        _position = _position == 0 ? Length - 1 : _position - 1;
+        _samples[_position]          = sample;
+        _samples[_position + Length] = sample;
+    }
+
+    // window()[k] is the sample pushed k pushes ago
+    [[nodiscard]] constexpr std::span<const T, Length> window() const noexcept
+    {
+        return std::span<const T, Length>{_samples.data() + _position, Length};
+    }
+
+    constexpr void reset() noexcept
+    {
+        _samples.fill(T{});
+        _position = 0;
+    }
+};
+} // namespace bit::dsp
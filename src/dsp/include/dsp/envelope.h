@@ -0,0 +1,448 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace bit::dsp
+{
+enum class envelope_curve
+{
+    linear,
+    // RC like, aims past the end level so that it still gets there in time
+    exponential,
+};
+
+// segment lengths in samples
+struct adsr_parameters
+{
+    size_t attack                = 0;
+    size_t decay                 = 0;
+    qu<1, 31> sustain            = qu<1, 31>{1.0};
+    size_t release               = 0;
+    envelope_curve attack_curve  = envelope_curve::linear;
+    envelope_curve decay_curve   = envelope_curve::linear;
+    envelope_curve release_curve = envelope_curve::linear;
+};
+
+// Attack, decay, sustain, release envelope working on whole blocks. Segment
+// boundaries and trigger / release events are found once per block, which
+// splits it into a few runs; every run is filled with a linear ramp (start
+// plus index times step) or an exponential one, evaluated 8 lanes at a time
+// from precomputed powers of the per sample coefficient. Trigger and release
+// take a sample offset into the next block, so they are sample accurate.
+//
+// Retriggering or releasing in the middle of a segment starts the new one
+// from the current level, without a click.
+class adsr
+{
+  public:
+    using level_type = qu<1, 31>;
+
+    // queued trigger / release events per block
+    static constexpr size_t max_events = 8;
+
+  private:
+    enum class stage
+    {
+        idle,
+        attack,
+        decay,
+        sustain,
+        release,
+    };
+
+    static constexpr int64_t one    = int64_t{1} << 31;
+    static constexpr size_t lanes   = 8;
+    static constexpr size_t endless = std::numeric_limits<size_t>::max();
+
+    // how far past the end level an exponential segment aims, relative to
+    // its height; a slow start for the attack, -60 dB tails for the rest
+    static constexpr double attack_overshoot = 0.3;
+    static constexpr double tail_overshoot   = 0.001;
+
+    // c^0 ... c^(lanes - 1) and c^lanes, Q0.31
+    struct exponential_powers
+    {
+        std::array<int64_t, lanes> powers{};
+        int64_t stride{};
+
+        [[nodiscard]] static exponential_powers make(size_t length,
+                                                     double overshoot) noexcept
+        {
+            exponential_powers result;
+            if (length == 0)
+            {
+                return result;
+            }
+            auto coefficient = std::pow(overshoot / (1 + overshoot),
+                                        1.0 / static_cast<double>(length));
+            for (size_t j = 0; j < lanes; ++j)
+            {
+                result.powers[j] = std::llround(
+                    std::pow(coefficient, static_cast<double>(j)) * one);
+            }
+            result.stride = std::llround(
+                std::pow(coefficient, static_cast<double>(lanes)) * one);
+            return result;
+        }
+    };
+
+    struct event
+    {
+        size_t offset;
+        bool trigger;
+    };
+
+    adsr_parameters _parameters;
+    exponential_powers _attack_powers;
+    exponential_powers _decay_powers;
+    exponential_powers _release_powers;
+
+    stage _stage          = stage::idle;
+    size_t _remaining     = endless;
+    int64_t _level        = 0;
+    int64_t _end_level    = 0;
+    envelope_curve _curve = envelope_curve::linear;
+    // linear: level += step per sample
+    int64_t _step = 0;
+    // exponential: level = asymptote + distance, distance *= c per sample
+    int64_t _asymptote                     = 0;
+    int64_t _distance                      = 0;
+    const exponential_powers* _exponential = nullptr;
+
+    std::array<event, max_events> _events{};
+    size_t _event_count = 0;
+
+    void start(stage next,
+               size_t length,
+               int64_t end_level,
+               envelope_curve curve,
+               const exponential_powers& powers,
+               double overshoot) noexcept
+    {
+        _stage     = next;
+        _end_level = end_level;
+        if (length == 0)
+        {
+            _level     = end_level;
+            _remaining = 0;
+            return;
+        }
+        _remaining = length;
+        _curve     = curve;
+        if (curve == envelope_curve::linear)
+        {
+            _step = (end_level - _level) / static_cast<int64_t>(length);
+        }
+        else
+        {
+            auto height  = static_cast<double>(end_level - _level);
+            _asymptote   = end_level + std::llround(height * overshoot);
+            _distance    = _level - _asymptote;
+            _exponential = &powers;
+        }
+    }
+
+    void start_attack() noexcept
+    {
+        start(stage::attack,
+              _parameters.attack,
+              one,
+              _parameters.attack_curve,
+              _attack_powers,
+              attack_overshoot);
+    }
+
+    void start_decay() noexcept
+    {
+        start(stage::decay,
+              _parameters.decay,
+              static_cast<int64_t>(_parameters.sustain.raw()),
+              _parameters.decay_curve,
+              _decay_powers,
+              tail_overshoot);
+    }
+
+    void start_sustain() noexcept
+    {
+        _stage     = stage::sustain;
+        _remaining = endless;
+        _level     = static_cast<int64_t>(_parameters.sustain.raw());
+    }
+
+    void start_release() noexcept
+    {
+        start(stage::release,
+              _parameters.release,
+              0,
+              _parameters.release_curve,
+              _release_powers,
+              tail_overshoot);
+    }
+
+    void enter_next_stage() noexcept
+    {
+        switch (_stage)
+        {
+        case stage::attack:
+            start_decay();
+            break;
+        case stage::decay:
+            start_sustain();
+            break;
+        case stage::release:
+            _stage     = stage::idle;
+            _remaining = endless;
+            _level     = 0;
+            break;
+        default:
+            break;
+        }
+    }
+
+    [[nodiscard]] static constexpr int64_t clamped(int64_t level) noexcept
+    {
+        return std::clamp<int64_t>(level, 0, one);
+    }
+
+    // fills count samples starting at index of the current segment
+    template <typename SinkT>
+    void fill(SinkT& sink, size_t index, size_t count) noexcept
+    {
+        auto ramping = _stage == stage::attack or _stage == stage::decay or
+                       _stage == stage::release;
+        if (not ramping)
+        {
+            auto level = clamped(_level);
+            for (size_t i = 0; i < count; ++i)
+            {
+                sink(index + i, level);
+            }
+        }
+        else if (_curve == envelope_curve::linear)
+        {
+            // lane offsets, so that the loop only adds
+            std::array<int64_t, lanes> offsets{};
+            for (size_t j = 0; j < lanes; ++j)
+            {
+                offsets[j] = static_cast<int64_t>(j) * _step;
+            }
+            auto stride = static_cast<int64_t>(lanes) * _step;
+            auto level  = _level;
+            size_t i    = 0;
+            for (; i + lanes <= count; i += lanes)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    sink(index + i + j, clamped(level + offsets[j]));
+                }
+                level += stride;
+            }
+            for (size_t j = 0; i + j < count; ++j)
+            {
+                sink(index + i + j, clamped(level + offsets[j]));
+            }
+            _level = level + offsets[count - i];
+        }
+        else
+        {
+            const auto& powers = _exponential->powers;
+            auto stride        = _exponential->stride;
+            auto asymptote     = _asymptote;
+            auto distance      = _distance;
+            size_t i           = 0;
+            for (; i + lanes <= count; i += lanes)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    sink(index + i + j,
+                         clamped(asymptote + ((distance * powers[j]) >> 31)));
+                }
+                distance = (distance * stride) >> 31;
+            }
+            for (size_t j = 0; i + j < count; ++j)
+            {
+                sink(index + i + j,
+                     clamped(asymptote + ((distance * powers[j]) >> 31)));
+            }
+            // the tail restarts at a lane boundary of the next run
+            _distance = (distance * powers[count - i]) >> 31;
+            _level    = asymptote + _distance;
+        }
+
+        if (_remaining != endless)
+        {
+            _remaining -= count;
+            if (_remaining == 0)
+            {
+                // snap away the ramp rounding
+                _level = _end_level;
+            }
+        }
+    }
+
+    template <typename SinkT> void process(size_t size, SinkT& sink) noexcept
+    {
+        size_t index      = 0;
+        size_t next_event = 0;
+        while (index < size)
+        {
+            while (next_event < _event_count and
+                   _events[next_event].offset <= index)
+            {
+                if (_events[next_event].trigger)
+                {
+                    start_attack();
+                }
+                else if (_stage != stage::idle)
+                {
+                    start_release();
+                }
+                ++next_event;
+            }
+            while (_remaining == 0)
+            {
+                enter_next_stage();
+            }
+
+            auto end = size;
+            if (next_event < _event_count)
+            {
+                end = std::min(end, _events[next_event].offset);
+            }
+            if (_remaining != endless)
+            {
+                end = std::min(end, index + _remaining);
+            }
+            fill(sink, index, end - index);
+            index = end;
+        }
+
+        // events past this block move to the next one
+        size_t kept = 0;
+        for (; next_event < _event_count; ++next_event)
+        {
+            _events[kept] = _events[next_event];
+            _events[kept].offset -= size;
+            ++kept;
+        }
+        _event_count = kept;
+    }
+
+    bool queue(size_t offset, bool trigger) noexcept
+    {
+        auto position = _event_count;
+        while (position > 0 and _events[position - 1].offset > offset)
+        {
+            --position;
+        }
+        if (_event_count == max_events)
+        {
+            // full: at the same offset only the last event counts, the
+            // new one takes its place; others are dropped
+            if (position > 0 and _events[position - 1].offset == offset)
+            {
+                _events[position - 1].trigger = trigger;
+                return true;
+            }
+            return false;
+        }
+        // stable, so events at the same offset keep their order
+        std::copy_backward(_events.begin() + position,
+                           _events.begin() + _event_count,
+                           _events.begin() + _event_count + 1);
+        _events[position] = {offset, trigger};
+        ++_event_count;
+        return true;
+    }
+
+  public:
+    explicit adsr(const adsr_parameters& parameters = {}) noexcept
+    {
+        set_parameters(parameters);
+    }
+
+    // lengths apply from the next segment on, the sustain level right away
+    void set_parameters(const adsr_parameters& parameters) noexcept
+    {
+        assert(parameters.sustain.raw() <= one);
+        _parameters = parameters;
+        _attack_powers =
+            exponential_powers::make(parameters.attack, attack_overshoot);
+        _decay_powers =
+            exponential_powers::make(parameters.decay, tail_overshoot);
+        _release_powers =
+            exponential_powers::make(parameters.release, tail_overshoot);
+        if (_stage == stage::sustain)
+        {
+            start_sustain();
+        }
+    }
+
+    [[nodiscard]] const adsr_parameters& parameters() const noexcept
+    {
+        return _parameters;
+    }
+
+    // offset in samples from the start of the next rendered block; false
+    // when max_events are queued and none of them at the offset, then the
+    // event is dropped
+    bool trigger(size_t offset = 0) noexcept
+    {
+        return queue(offset, true);
+    }
+
+    bool release(size_t offset = 0) noexcept
+    {
+        return queue(offset, false);
+    }
+
+    [[nodiscard]] bool is_active() const noexcept
+    {
+        return _stage != stage::idle or _event_count > 0;
+    }
+
+    [[nodiscard]] level_type level() const noexcept
+    {
+        return {as_is_t{static_cast<uint32_t>(clamped(_level))}};
+    }
+
+    void reset() noexcept
+    {
+        _stage       = stage::idle;
+        _remaining   = endless;
+        _level       = 0;
+        _event_count = 0;
+    }
+
+    void render(std::span<level_type> block) noexcept
+    {
+        auto sink = [block](size_t i, int64_t level) {
+            block[i] = {as_is_t{static_cast<uint32_t>(level)}};
+        };
+        process(block.size(), sink);
+    }
+
+    // multiplies the block by the envelope, e.g. as the voice gain
+    template <qformatted SampleQ>
+        requires(SampleQ::bits + SampleQ::is_signed <= 32)
+    void apply(std::span<SampleQ> block) noexcept
+    {
+        using value_type = typename SampleQ::value_type;
+        auto sink        = [block](size_t i, int64_t level) {
+            auto sample = static_cast<int64_t>(block[i].raw());
+            block[i]    = {
+                as_is_t{static_cast<value_type>((sample * level) >> 31)}};
+        };
+        process(block.size(), sink);
+    }
+};
+} // namespace bit::dsp
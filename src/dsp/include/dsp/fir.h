@@ -0,0 +1,247 @@
+#pragma once
+
+#include "dsp/delay_line.h"
+#include "math/accumulator.h"
+#include "math/qnumber.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <numbers>
+#include <span>
+
+#pragma warning(push)
+#pragma warning(disable : 5045)
+#include <gcem.hpp>
+#pragma warning(pop)
+
+namespace bit::dsp
+{
+// Blackman windowed sinc low pass, cutoff is relative to the sampling
+// frequency and has to be in (0, 0.5). Gain scales the passband, e.g. to
+// compensate zero stuffing of an interpolator.
+template <qformatted CoeffQ, size_t Taps>
+    requires(Taps > 1)
+constexpr std::array<CoeffQ, Taps> lowpass(double cutoff, double gain = 1.0)
+{
+    assert(0 < cutoff and cutoff < 0.5);
+    std::array<double, Taps> taps{};
+    double sum = 0;
+    for (size_t k = 0; k < Taps; ++k)
+    {
+        constexpr double middle = (Taps - 1) / 2.0;
+        auto t                  = k - middle;
+        auto sinc = t == 0 ? 2 * cutoff
+                           : gcem::sin(2 * std::numbers::pi * cutoff * t) /
+                                 (std::numbers::pi * t);
+        auto phase  = 2 * std::numbers::pi * k / (Taps - 1);
+        auto window =
+            0.42 - 0.5 * gcem::cos(phase) + 0.08 * gcem::cos(2 * phase);
+        taps[k]     = sinc * window;
+        sum += taps[k];
+    }
+
+    std::array<CoeffQ, Taps> coefficients{};
+    for (size_t k = 0; k < Taps; ++k)
+    {
+        coefficients[k] = CoeffQ{taps[k] * gain / sum};
+    }
+    return coefficients;
+}
+
+// Direct form FIR over qnumber blocks. Products are summed at full precision
+// with enough guard bits for all taps, so the only clamp per output sample is
+// the final narrowing into OutputQ.
+template <qformatted CoeffQ,
+          qformatted SampleQ,
+          size_t Taps,
+          qformatted OutputQ = SampleQ>
+    requires(Taps > 0)
+class fir
+{
+  public:
+    using coefficient_type = CoeffQ;
+    using sample_type      = SampleQ;
+    using output_type      = OutputQ;
+
+    static constexpr size_t taps       = Taps;
+    static constexpr size_t guard_bits = std::bit_width(Taps);
+
+  private:
+    std::array<CoeffQ, Taps> _coefficients{};
+    delay_line<SampleQ, Taps> _history;
+
+  public:
+    constexpr fir() = default;
+
+    constexpr explicit fir(const std::array<CoeffQ, Taps>& coefficients)
+        : _coefficients(coefficients)
+    {
+    }
+
+    constexpr void set_coefficients(
+        const std::array<CoeffQ, Taps>& coefficients) noexcept
+    {
+        _coefficients = coefficients;
+    }
+
+    [[nodiscard]] constexpr const std::array<CoeffQ, Taps>& coefficients()
+        const noexcept
+    {
+        return _coefficients;
+    }
+
+    constexpr void reset() noexcept
+    {
+        _history.reset();
+    }
+
+    constexpr OutputQ process(SampleQ sample) noexcept
+    {
+        _history.push(sample);
+        return bit::dot<guard_bits>(std::span<const CoeffQ>{_coefficients},
+                                    std::span<const SampleQ>{_history.window()})
+            .template narrow_as<OutputQ>();
+    }
+
+    constexpr void process(std::span<const SampleQ> input,
+                           std::span<OutputQ> output) noexcept
+    {
+        assert(input.size() <= output.size());
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            output[i] = process(input[i]);
+        }
+    }
+};
+
+// Keeps every Factor-th output of fir<CoeffQ, SampleQ, Taps>, the dot product
+// is evaluated only for the kept outputs.
+template <qformatted CoeffQ,
+          qformatted SampleQ,
+          size_t Taps,
+          size_t Factor,
+          qformatted OutputQ = SampleQ>
+    requires(Taps > 0 and Factor > 0)
+class fir_decimator
+{
+  public:
+    using coefficient_type = CoeffQ;
+    using sample_type      = SampleQ;
+    using output_type      = OutputQ;
+
+    static constexpr size_t taps       = Taps;
+    static constexpr size_t factor     = Factor;
+    static constexpr size_t guard_bits = std::bit_width(Taps);
+
+  private:
+    std::array<CoeffQ, Taps> _coefficients{};
+    delay_line<SampleQ, Taps> _history;
+    size_t _phase = 0;
+
+  public:
+    constexpr fir_decimator() = default;
+
+    constexpr explicit fir_decimator(
+        const std::array<CoeffQ, Taps>& coefficients)
+        : _coefficients(coefficients)
+    {
+    }
+
+    constexpr void reset() noexcept
+    {
+        _history.reset();
+        _phase = 0;
+    }
+
+    // returns the number of outputs written, output has to have room for
+    // input.size() / Factor + 1 samples
+    constexpr size_t process(std::span<const SampleQ> input,
+                             std::span<OutputQ> output) noexcept
+    {
+        size_t written = 0;
+        for (auto sample : input)
+        {
+            _history.push(sample);
+            if (_phase == 0)
+            {
+                assert(written < output.size());
+                output[written++] =
+                    bit::dot<guard_bits>(
+                        std::span<const CoeffQ>{_coefficients},
+                        std::span<const SampleQ>{_history.window()})
+                        .template narrow_as<OutputQ>();
+            }
+            _phase = _phase + 1 == Factor ? 0 : _phase + 1;
+        }
+        return written;
+    }
+};
+
+// Upsamples by Factor as fir<CoeffQ, SampleQ, Taps> would after zero
+// stuffing, but runs Factor polyphase subfilters of Taps / Factor taps over
+// the original samples, so the zeros are never multiplied.
+template <qformatted CoeffQ,
+          qformatted SampleQ,
+          size_t Taps,
+          size_t Factor,
+          qformatted OutputQ = SampleQ>
+    requires(Factor > 0 and Taps % Factor == 0)
+class fir_interpolator
+{
+  public:
+    using coefficient_type = CoeffQ;
+    using sample_type      = SampleQ;
+    using output_type      = OutputQ;
+
+    static constexpr size_t taps       = Taps;
+    static constexpr size_t factor     = Factor;
+    static constexpr size_t phase_taps = Taps / Factor;
+    static constexpr size_t guard_bits = std::bit_width(phase_taps);
+
+  private:
+    // _phases[p][k] == coefficients[k * Factor + p]
+    std::array<std::array<CoeffQ, phase_taps>, Factor> _phases{};
+    delay_line<SampleQ, phase_taps> _history;
+
+  public:
+    constexpr fir_interpolator() = default;
+
+    constexpr explicit fir_interpolator(
+        const std::array<CoeffQ, Taps>& coefficients)
+    {
+        for (size_t k = 0; k < phase_taps; ++k)
+        {
+            for (size_t p = 0; p < Factor; ++p)
+            {
+                _phases[p][k] = coefficients[k * Factor + p];
+            }
+        }
+    }
+
+    constexpr void reset() noexcept
+    {
+        _history.reset();
+    }
+
+    // output has to have room for input.size() * Factor samples
+    constexpr void process(std::span<const SampleQ> input,
+                           std::span<OutputQ> output) noexcept
+    {
+        assert(input.size() * Factor <= output.size());
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            _history.push(input[i]);
+            for (size_t p = 0; p < Factor; ++p)
+            {
+                output[i * Factor + p] =
+                    bit::dot<guard_bits>(
+                        std::span<const CoeffQ>{_phases[p]},
+                        std::span<const SampleQ>{_history.window()})
+                        .template narrow_as<OutputQ>();
+            }
+        }
+    }
+};
+} // namespace bit::dsp
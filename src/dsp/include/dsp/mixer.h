@@ -0,0 +1,160 @@
+#pragma once
+
+#include "math/accumulator.h"
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace bit::dsp
+{
+// Sums mono voice blocks into a stereo bus. Every voice is scaled by its
+// gain and panned with a constant power law into left and right gains, which
+// multiply into full precision accumulators with GuardBits of headroom; the
+// bus is saturated once per sample, when the sums are narrowed to BusQ.
+//
+// Mixing goes over the bus in chunks that stay in L1, voice after voice in
+// index order, so each voice block is read once and sequentially and the
+// inner loop is a vectorizable multiply-add. Integer sums don't depend on
+// the order anyway, so the render is bit exact run to run.
+template <qformatted VoiceQ, qformatted BusQ = VoiceQ, size_t GuardBits = 8>
+    requires(VoiceQ::is_signed and BusQ::is_signed)
+class mixer
+{
+  public:
+    using voice_type = VoiceQ;
+    using bus_type   = BusQ;
+    // per channel voice gain, below +6 dB
+    using gain_type = qs<1, 14>;
+
+    // every voice at full scale and full gain still fits the accumulators
+    static constexpr size_t max_voices = size_t{1} << GuardBits;
+
+  private:
+    using accumulator_type = product_accumulator<gain_type, VoiceQ, GuardBits>;
+
+    // frames per pass, a few KiB of accumulators for both channels
+    static constexpr size_t chunk = 256;
+
+    struct voice_gains
+    {
+        gain_type left{};
+        gain_type right{};
+    };
+
+    std::vector<voice_gains> _voices;
+    std::array<accumulator_type, chunk> _left{};
+    std::array<accumulator_type, chunk> _right{};
+
+    void accumulate(std::span<const std::span<const VoiceQ>> voices,
+                    size_t start,
+                    size_t count) noexcept
+    {
+        std::ranges::fill(_left, accumulator_type{});
+        std::ranges::fill(_right, accumulator_type{});
+        for (size_t v = 0; v < voices.size(); ++v)
+        {
+            auto [left, right] = _voices[v];
+            if (left.raw() == 0 and right.raw() == 0)
+            {
+                continue;
+            }
+            assert(voices[v].size() >= start + count);
+            const auto* samples = voices[v].data() + start;
+            for (size_t i = 0; i < count; ++i)
+            {
+                _left[i].mac(left, samples[i]);
+                _right[i].mac(right, samples[i]);
+            }
+        }
+    }
+
+  public:
+    explicit mixer(size_t voices) : _voices(voices)
+    {
+        if (voices > max_voices)
+        {
+            throw std::range_error{"too many voices for the guard bits"};
+        }
+        for (size_t v = 0; v < voices; ++v)
+        {
+            set_voice(v, 1.0, 0.0);
+        }
+    }
+
+    [[nodiscard]] size_t voices() const noexcept
+    {
+        return _voices.size();
+    }
+
+    // pan from -1 (left) to 1 (right); the center is -3 dB per channel.
+    // Channel gains beyond gain_type, +6 dB and up, are clamped to it.
+    void set_voice(size_t voice, double gain, double pan) noexcept
+    {
+        assert(voice < _voices.size());
+        assert(pan >= -1 and pan <= 1);
+        auto angle   = (pan + 1) * std::numbers::pi / 4;
+        auto channel = [](double value) {
+            using limits = std::numeric_limits<gain_type>;
+            return gain_type{std::clamp(value,
+                                        limits::lowest().template as<double>(),
+                                        limits::max().template as<double>())};
+        };
+        _voices[voice] = {channel(gain * std::cos(angle)),
+                          channel(gain * std::sin(angle))};
+    }
+
+    void set_voice(size_t voice, gain_type left, gain_type right) noexcept
+    {
+        assert(voice < _voices.size());
+        _voices[voice] = {left, right};
+    }
+
+    // bus as interleaved left, right frames
+    void mix(std::span<const std::span<const VoiceQ>> voices,
+             std::span<BusQ> bus) noexcept
+    {
+        assert(voices.size() <= _voices.size());
+        assert(bus.size() % 2 == 0);
+        auto frames = bus.size() / 2;
+        for (size_t start = 0; start < frames; start += chunk)
+        {
+            auto count = std::min(chunk, frames - start);
+            accumulate(voices, start, count);
+            auto* out = bus.data() + 2 * start;
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[2 * i]     = _left[i].template narrow_as<BusQ>();
+                out[2 * i + 1] = _right[i].template narrow_as<BusQ>();
+            }
+        }
+    }
+
+    // bus as separate left and right blocks
+    void mix(std::span<const std::span<const VoiceQ>> voices,
+             std::span<BusQ> left,
+             std::span<BusQ> right) noexcept
+    {
+        assert(voices.size() <= _voices.size());
+        assert(left.size() == right.size());
+        for (size_t start = 0; start < left.size(); start += chunk)
+        {
+            auto count = std::min(chunk, left.size() - start);
+            accumulate(voices, start, count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                left[start + i]  = _left[i].template narrow_as<BusQ>();
+                right[start + i] = _right[i].template narrow_as<BusQ>();
+            }
+        }
+    }
+};
+} // namespace bit::dsp
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "math/accumulator.h"
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#pragma warning(push)
+#pragma warning(disable : 5045)
+#include <gcem.hpp>
+#pragma warning(pop)
+
+namespace bit::dsp
+{
+// Blackman windowed halfband low pass of 4 * HalfTaps - 1 taps, cutoff at a
+// quarter of the sampling frequency. Every other tap is zero apart from the
+// center one, which is gain / 2, and the rest is symmetric, so only the
+// HalfTaps coefficients at odd distances 1, 3, 5... from the center are
+// returned. They sum to gain / 4, which makes the DC gain exactly gain.
+template <qformatted CoeffQ, size_t HalfTaps>
+    requires(HalfTaps > 0)
+constexpr std::array<CoeffQ, HalfTaps> halfband(double gain = 1.0)
+{
+    constexpr double length = 4 * HalfTaps;
+    std::array<double, HalfTaps> taps{};
+    double sum = 0;
+    for (size_t m = 0; m < HalfTaps; ++m)
+    {
+        auto t = static_cast<double>(2 * m + 1);
+        // window one tap wider on both sides, so the outer taps aren't zero
+        auto phase  = 2 * std::numbers::pi * (length / 2 + t) / length;
+        auto window =
+            0.42 - 0.5 * gcem::cos(phase) + 0.08 * gcem::cos(2 * phase);
+        taps[m] = gcem::sin(std::numbers::pi * t / 2) /
+                  (std::numbers::pi * t) * window;
+        sum += taps[m];
+    }
+
+    std::array<CoeffQ, HalfTaps> coefficients{};
+    for (size_t m = 0; m < HalfTaps; ++m)
+    {
+        coefficients[m] = CoeffQ{taps[m] * gain / (4 * sum)};
+    }
+    return coefficients;
+}
+
+namespace detail
+{
+template <qformatted SampleQ>
+using halfband_coefficient =
+    std::conditional_t<(SampleQ::bits <= 15), qs<0, 15>, qs<0, 22>>;
+
+template <qformatted SampleQ, size_t HalfTaps> struct halfband_types
+{
+    using coefficient_type = halfband_coefficient<SampleQ>;
+    // two samples mirrored around the center share a coefficient
+    using pair_type =
+        decltype(std::declval<SampleQ>().add(std::declval<SampleQ>()));
+    using accumulator_type =
+        product_accumulator<coefficient_type,
+                            pair_type,
+                            std::bit_width(HalfTaps + 1)>;
+
+    // samples before the block the filter reaches back to
+    static constexpr size_t history = 2 * HalfTaps - 1;
+};
+} // namespace detail
+
+// Upsamples by 2 as a halfband filter after zero stuffing would. Of the two
+// polyphase branches one is a pure delay and the other a symmetric filter,
+// which costs HalfTaps multiplies per input sample. The filter runs over
+// the whole block one coefficient at a time, so the inner loop goes along
+// the block and vectorizes.
+template <qformatted SampleQ, size_t HalfTaps> class halfband_interpolator
+{
+  public:
+    using sample_type = SampleQ;
+    using types       = detail::halfband_types<SampleQ, HalfTaps>;
+
+    // in input samples
+    static constexpr double latency = (2 * HalfTaps - 1) / 2.0;
+
+  private:
+    using coefficient_type = typename types::coefficient_type;
+    using accumulator_type = typename types::accumulator_type;
+
+    static constexpr size_t history = types::history;
+
+    std::array<coefficient_type, HalfTaps> _coefficients =
+        halfband<coefficient_type, HalfTaps>(2.0);
+    // history followed by the current block
+    std::vector<SampleQ> _input;
+    std::vector<accumulator_type> _sums;
+
+  public:
+    explicit halfband_interpolator(size_t max_block)
+        : _input(history + max_block), _sums(max_block)
+    {
+    }
+
+    void reset() noexcept
+    {
+        std::fill_n(_input.begin(), history, SampleQ{});
+    }
+
+    // output has to have room for 2 * input.size() samples
+    void process(std::span<const SampleQ> input,
+                 std::span<SampleQ> output) noexcept
+    {
+        assert(input.size() <= _sums.size());
+        assert(2 * input.size() <= output.size());
+        auto size = input.size();
+        std::ranges::copy(input, _input.begin() + history);
+        // x[j] is input j, x[j - k] the one k samples before it
+        const auto* x = _input.data() + history;
+
+        std::fill_n(_sums.begin(), size, accumulator_type{});
+        for (size_t m = 0; m < HalfTaps; ++m)
+        {
+            auto coefficient = _coefficients[m];
+            const auto* near = x - (HalfTaps - 1 - m);
+            const auto* far  = x - (HalfTaps + m);
+            for (size_t j = 0; j < size; ++j)
+            {
+                _sums[j].mac(coefficient, near[j].add(far[j]));
+            }
+        }
+        const auto* center = x - (HalfTaps - 1);
+        for (size_t j = 0; j < size; ++j)
+        {
+            output[2 * j]     = _sums[j].template narrow_as<SampleQ>();
+            output[2 * j + 1] = center[j];
+        }
+
+        std::copy_n(_input.begin() + static_cast<ptrdiff_t>(size),
+                    history,
+                    _input.begin());
+    }
+};
+
+// Downsamples by 2 after a halfband filter. The input is split into even
+// and odd samples: the even branch only has the center tap, the odd one is
+// symmetric, so it's HalfTaps + 1 multiplies per output sample.
+template <qformatted SampleQ, size_t HalfTaps> class halfband_decimator
+{
+  public:
+    using sample_type = SampleQ;
+    using types       = detail::halfband_types<SampleQ, HalfTaps>;
+
+    // in output samples
+    static constexpr double latency = HalfTaps - 1;
+
+  private:
+    using coefficient_type = typename types::coefficient_type;
+    using accumulator_type = typename types::accumulator_type;
+
+    static constexpr size_t history = types::history;
+    static constexpr coefficient_type half{0.5};
+
+    std::array<coefficient_type, HalfTaps> _coefficients =
+        halfband<coefficient_type, HalfTaps>();
+    std::vector<SampleQ> _even;
+    std::vector<SampleQ> _odd;
+    std::vector<accumulator_type> _sums;
+
+  public:
+    // max_block of output samples
+    explicit halfband_decimator(size_t max_block)
+        : _even(history + max_block), _odd(history + max_block),
+          _sums(max_block)
+    {
+    }
+
+    void reset() noexcept
+    {
+        std::fill_n(_even.begin(), history, SampleQ{});
+        std::fill_n(_odd.begin(), history, SampleQ{});
+    }
+
+    // input has an even number of samples, output room for half of them
+    void process(std::span<const SampleQ> input,
+                 std::span<SampleQ> output) noexcept
+    {
+        assert(input.size() % 2 == 0);
+        auto size = input.size() / 2;
+        assert(size <= _sums.size() and size <= output.size());
+        for (size_t j = 0; j < size; ++j)
+        {
+            _even[history + j] = input[2 * j];
+            _odd[history + j]  = input[2 * j + 1];
+        }
+        const auto* even = _even.data() + history;
+        const auto* odd  = _odd.data() + history;
+
+        const auto* center = even - (HalfTaps - 1);
+        for (size_t j = 0; j < size; ++j)
+        {
+            _sums[j] = accumulator_type{};
+            _sums[j].mac(half, center[j]);
+        }
+        for (size_t m = 0; m < HalfTaps; ++m)
+        {
+            auto coefficient = _coefficients[m];
+            const auto* near = odd - (HalfTaps - 1 - m);
+            const auto* far  = odd - (HalfTaps + m);
+            for (size_t j = 0; j < size; ++j)
+            {
+                _sums[j].mac(coefficient, near[j].add(far[j]));
+            }
+        }
+        for (size_t j = 0; j < size; ++j)
+        {
+            output[j] = _sums[j].template narrow_as<SampleQ>();
+        }
+
+        auto shift = static_cast<ptrdiff_t>(size);
+        std::copy_n(_even.begin() + shift, history, _even.begin());
+        std::copy_n(_odd.begin() + shift, history, _odd.begin());
+    }
+};
+
+// Runs an in place block stage, e.g. a bitcrusher or any other nonlinearity,
+// at Factor times the sampling rate: the block goes up through a cascade of
+// halfband interpolators, through the stage, and back down through the
+// mirrored decimators, which remove what the stage generated above the
+// original Nyquist frequency before it can alias.
+//
+// The first halfband pair has to be steep, the later ones only remove
+// images far from the signal and are much shorter. Buffers are allocated
+// for max_block samples up front, longer blocks are processed in parts.
+// The decimators saturate, so a stage driving its output to full scale gets
+// the overshoot of the filters clipped.
+template <size_t Factor,
+          typename Stage,
+          qformatted SampleQ = typename Stage::sample_type>
+    requires(Factor == 2 or Factor == 4 or Factor == 8)
+class oversampled
+{
+  public:
+    using sample_type = SampleQ;
+    using stage_type  = Stage;
+
+    static constexpr size_t factor = Factor;
+
+  private:
+    static constexpr size_t steep_taps   = 16;
+    static constexpr size_t shallow_taps = 8;
+    static constexpr size_t cascade      = std::bit_width(Factor) - 1;
+
+    using steep_up     = halfband_interpolator<SampleQ, steep_taps>;
+    using steep_down   = halfband_decimator<SampleQ, steep_taps>;
+    using shallow_up   = halfband_interpolator<SampleQ, shallow_taps>;
+    using shallow_down = halfband_decimator<SampleQ, shallow_taps>;
+
+    Stage _stage;
+    size_t _max_block;
+    steep_up _first_up;
+    steep_down _first_down;
+    // stage k works from Factor / 2^k to twice that
+    std::vector<shallow_up> _ups;
+    std::vector<shallow_down> _downs;
+    std::vector<SampleQ> _ping;
+    std::vector<SampleQ> _pong;
+
+    void process_part(std::span<SampleQ> block) noexcept
+    {
+        auto size = block.size();
+        std::span<SampleQ> current{_ping.data(), 2 * size};
+        std::span<SampleQ> other{_pong.data(), _pong.size()};
+        _first_up.process(block, current);
+        for (auto& up : _ups)
+        {
+            auto next = other.first(2 * current.size());
+            up.process(current, next);
+            other   = std::span{current.data(), _ping.size()};
+            current = next;
+        }
+
+        _stage.process(current);
+
+        for (size_t k = _downs.size(); k-- > 0;)
+        {
+            auto next = other.first(current.size() / 2);
+            _downs[k].process(current, next);
+            other   = std::span{current.data(), _ping.size()};
+            current = next;
+        }
+        _first_down.process(current, block);
+    }
+
+  public:
+    explicit oversampled(size_t max_block, Stage stage = {})
+        : _stage{std::move(stage)}, _max_block{max_block},
+          _first_up{max_block}, _first_down{max_block},
+          _ping(Factor * max_block), _pong(Factor * max_block)
+    {
+        for (size_t k = 1; k < cascade; ++k)
+        {
+            _ups.emplace_back(max_block << k);
+            _downs.emplace_back(max_block << k);
+        }
+    }
+
+    [[nodiscard]] Stage& stage() noexcept
+    {
+        return _stage;
+    }
+
+    [[nodiscard]] const Stage& stage() const noexcept
+    {
+        return _stage;
+    }
+
+    // of the filters, in samples at the original rate
+    [[nodiscard]] static constexpr double latency() noexcept
+    {
+        double total = steep_up::latency + steep_down::latency;
+        for (size_t k = 1; k < cascade; ++k)
+        {
+            auto rate = static_cast<double>(size_t{1} << k);
+            total += (shallow_up::latency + shallow_down::latency) / rate;
+        }
+        return total;
+    }
+
+    void reset() noexcept
+    {
+        _first_up.reset();
+        _first_down.reset();
+        for (auto& up : _ups)
+        {
+            up.reset();
+        }
+        for (auto& down : _downs)
+        {
+            down.reset();
+        }
+    }
+
+    void process(std::span<SampleQ> block) noexcept
+    {
+        for (size_t start = 0; start < block.size(); start += _max_block)
+        {
+            process_part(block.subspan(
+                start, std::min(_max_block, block.size() - start)));
+        }
+    }
+};
+} // namespace bit::dsp
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <cassert>
+
+namespace bit::dsp
+{
+// one cycle is the full range of the container, so the phase wraps for free
+using phase_type = qu<0, 32>;
+
+[[nodiscard]] constexpr phase_type phase_increment(double frequency,
+                                                   double sampling_frequency)
+{
+    assert(0 <= frequency and frequency < sampling_frequency / 2);
+    return phase_type{frequency / sampling_frequency};
+}
+} // namespace bit::dsp
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace bit::dsp
+{
+enum class noise_shaping
+{
+    none,
+    // error fed back through 1 - z^-1, +6 dB per octave towards Nyquist
+    first_order,
+    // (1 - z^-1)^2, +12 dB per octave
+    second_order,
+};
+
+namespace detail
+{
+// splitmix64 finalizer of a counter: every sample has its own random word,
+// computed independently of the others, so whole blocks of it vectorize and
+// the sequence doesn't depend on how the stream is split into blocks
+[[nodiscard]] constexpr uint64_t counter_random(uint64_t seed,
+                                                uint64_t counter) noexcept
+{
+    auto z = seed + (counter + 1) * 0x9e3779b97f4a7c15u;
+    z      = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z      = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+}
+} // namespace detail
+
+// Narrows FromQ blocks to the fewer fraction bits of ToQ in one pass:
+// optional TPDF dither of +-1 output lsb, optional error feedback noise
+// shaping, rounding and saturation. Dither comes from a counter based
+// generator, so the output is bit exact for a seed regardless of the block
+// sizes.
+//
+// Dither is generated for a chunk of samples at a time in vector lanes;
+// without shaping the quantizer vectorizes as well, with it the feedback
+// makes the chunk loop serial, but the chunk stays in L1.
+template <qformatted FromQ, qformatted ToQ>
+    requires(FromQ::is_signed and ToQ::is_signed and
+             FromQ::fraction_bits > ToQ::fraction_bits and
+             FromQ::bits + 1 <= 60 and ToQ::bits + 1 <= 64)
+class requantizer
+{
+  public:
+    using input_type  = FromQ;
+    using output_type = ToQ;
+
+  private:
+    using value_type = typename ToQ::value_type;
+
+    static constexpr size_t shift = FromQ::fraction_bits - ToQ::fraction_bits;
+    static constexpr int64_t lsb  = int64_t{1} << shift;
+    static constexpr int64_t half = lsb / 2;
+    static constexpr auto lowest =
+        static_cast<int64_t>(std::numeric_limits<ToQ>::lowest().raw());
+    static constexpr auto highest =
+        static_cast<int64_t>(std::numeric_limits<ToQ>::max().raw());
+
+    static constexpr size_t chunk = 64;
+
+    uint64_t _seed;
+    uint64_t _counter = 0;
+    noise_shaping _shaping;
+    bool _dither;
+    // last two quantization errors, in input lsb
+    int64_t _error1 = 0;
+    int64_t _error2 = 0;
+
+    // difference of two uniform 32-bit words, triangular over +-1 output lsb
+    void fill_dither(std::span<int64_t> dither) const noexcept
+    {
+        for (size_t i = 0; i < dither.size(); ++i)
+        {
+            auto z = detail::counter_random(_seed, _counter + i);
+            auto d = static_cast<int64_t>(z & 0xffffffffu) -
+                     static_cast<int64_t>(z >> 32);
+            if constexpr (shift >= 32)
+            {
+                dither[i] = d * (int64_t{1} << (shift - 32));
+            }
+            else
+            {
+                dither[i] = d >> (32 - shift);
+            }
+        }
+    }
+
+    template <noise_shaping Shaping>
+    void quantize(std::span<const FromQ> input,
+                  std::span<ToQ> output,
+                  const int64_t* dither) noexcept
+    {
+        auto error1 = _error1;
+        auto error2 = _error2;
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            auto wanted = static_cast<int64_t>(input[i].raw());
+            if constexpr (Shaping == noise_shaping::first_order)
+            {
+                wanted -= error1;
+            }
+            else if constexpr (Shaping == noise_shaping::second_order)
+            {
+                wanted -= 2 * error1 - error2;
+            }
+            // arithmetic shift, so rounds half up for negative values too
+            auto quantized = (wanted + dither[i] + half) >> shift;
+            if constexpr (Shaping != noise_shaping::none)
+            {
+                // before saturation, so that clipping can't wind it up
+                error2 = error1;
+                error1 = quantized * lsb - wanted;
+            }
+            output[i] = {as_is_t{static_cast<value_type>(
+                std::clamp(quantized, lowest, highest))}};
+        }
+        _error1 = error1;
+        _error2 = error2;
+    }
+
+  public:
+    explicit requantizer(uint64_t seed         = 0,
+                         noise_shaping shaping = noise_shaping::none,
+                         bool dither           = true) noexcept
+        : _seed{seed}, _shaping{shaping}, _dither{dither}
+    {
+    }
+
+    void set_shaping(noise_shaping shaping) noexcept
+    {
+        _shaping = shaping;
+    }
+
+    void set_dither(bool dither) noexcept
+    {
+        _dither = dither;
+    }
+
+    // restarts the dither sequence and clears the feedback
+    void reset(uint64_t seed) noexcept
+    {
+        _seed = seed;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        _counter = 0;
+        _error1  = 0;
+        _error2  = 0;
+    }
+
+    void process(std::span<const FromQ> input, std::span<ToQ> output) noexcept
+    {
+        assert(output.size() >= input.size());
+        std::array<int64_t, chunk> dither{};
+        for (size_t start = 0; start < input.size(); start += chunk)
+        {
+            auto count = std::min(chunk, input.size() - start);
+            auto in    = input.subspan(start, count);
+            auto out   = output.subspan(start, count);
+            if (_dither)
+            {
+                fill_dither(std::span{dither}.first(count));
+            }
+            // the counter runs without dither too, so toggling it doesn't
+            // shift the sequence
+            _counter += count;
+
+            switch (_shaping)
+            {
+            case noise_shaping::none:
+                quantize<noise_shaping::none>(in, out, dither.data());
+                break;
+            case noise_shaping::first_order:
+                quantize<noise_shaping::first_order>(in, out, dither.data());
+                break;
+            case noise_shaping::second_order:
+                quantize<noise_shaping::second_order>(in, out, dither.data());
+                break;
+            }
+        }
+    }
+};
+} // namespace bit::dsp
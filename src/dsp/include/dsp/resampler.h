@@ -0,0 +1,282 @@
+#pragma once
+
+#include "math/accumulator.h"
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace bit::dsp
+{
+enum class resampler_quality
+{
+    low,    // 8 taps per phase when interpolating, ~-50 dB stop band
+    medium, // 16 taps, ~-70 dB
+    high,   // 32 taps, ~-90 dB
+};
+
+struct resample_result
+{
+    size_t consumed;
+    size_t produced;
+};
+
+namespace detail
+{
+struct resampler_design
+{
+    size_t taps;
+    double beta;      // kaiser window
+    double bandwidth; // pass band edge relative to the lower nyquist
+};
+
+[[nodiscard]] constexpr resampler_design design_for(
+    resampler_quality quality) noexcept
+{
+    switch (quality)
+    {
+    case resampler_quality::low:
+        return {8, 5.0, 0.80};
+    case resampler_quality::medium:
+        return {16, 7.0, 0.88};
+    case resampler_quality::high:
+    default:
+        return {32, 9.0, 0.92};
+    }
+}
+
+// zeroth order modified bessel function of the first kind
+[[nodiscard]] inline double bessel_i0(double x) noexcept
+{
+    double sum  = 1;
+    double term = 1;
+    for (int k = 1; k < 50 and term > sum * 1e-17; ++k)
+    {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+template <typename SampleT> struct default_coefficient
+{
+    using type = SampleT;
+};
+
+template <qformatted SampleQ> struct default_coefficient<SampleQ>
+{
+    // 16-bit coefficients for 16-bit samples multiply in 32-bit lanes; wider
+    // samples get coefficients well below the stop band that still leave
+    // the 64-bit accumulator its guard bits
+    using type =
+        std::conditional_t<(SampleQ::bits <= 15), qs<1, 14>, qs<1, 22>>;
+};
+} // namespace detail
+
+// Streaming polyphase sample rate converter by the rational ratio
+// output_rate / input_rate, reduced to up / down. The kaiser windowed sinc
+// prototype of up * taps coefficients is split into up phases when the
+// resampler is built; every output sample is then one taps long inner
+// product of the newest input samples with one phase, and the input history
+// is stored twice so that the product never wraps.
+//
+// Works on float blocks or on qnumber blocks, where the inner product is
+// summed in an accumulator and saturated once.
+template <typename SampleT,
+          typename CoeffT = typename detail::default_coefficient<SampleT>::type>
+    requires(std::floating_point<SampleT> or qformatted<SampleT>)
+class resampler
+{
+  public:
+    using sample_type      = SampleT;
+    using coefficient_type = CoeffT;
+
+  private:
+    // taps per phase, lanes of 8 in the inner product
+    static constexpr size_t max_taps   = 256;
+    static constexpr size_t guard_bits = std::bit_width(max_taps - 1);
+
+    size_t _up;
+    size_t _down;
+    size_t _taps;
+    // _coefficients[phase * _taps + k] multiplies the input k samples old
+    std::vector<CoeffT> _coefficients;
+    std::vector<SampleT> _history;
+    size_t _position = 0;
+    // position between input samples, in 1 / _up of an input sample
+    size_t _phase;
+
+    void push(SampleT sample) noexcept
+    {
+        _position           = _position == 0 ? _taps - 1 : _position - 1;
+        _history[_position] = sample;
+        _history[_position + _taps] = sample;
+    }
+
+    [[nodiscard]] SampleT inner_product(size_t phase) const noexcept
+    {
+        const auto* window       = _history.data() + _position;
+        const auto* coefficients = _coefficients.data() + phase * _taps;
+        if constexpr (std::floating_point<SampleT>)
+        {
+            // independent partial sums, so the reduction vectorizes without
+            // reassociating floating point math
+            constexpr size_t lanes = 8;
+            std::array<SampleT, lanes> sums{};
+            for (size_t k = 0; k < _taps; k += lanes)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    sums[j] += static_cast<SampleT>(coefficients[k + j]) *
+                               window[k + j];
+                }
+            }
+            return std::accumulate(sums.begin(), sums.end(), SampleT{});
+        }
+        else
+        {
+            return dot<guard_bits>(std::span<const CoeffT>{coefficients, _taps},
+                          std::span<const SampleT>{window, _taps})
+                .template narrow_as<SampleT>();
+        }
+    }
+
+  public:
+    resampler(uint32_t input_rate,
+              uint32_t output_rate,
+              resampler_quality quality = resampler_quality::medium)
+    {
+        if (input_rate == 0 or output_rate == 0)
+        {
+            throw std::range_error{"sample rates have to be positive"};
+        }
+        auto divisor = std::gcd(input_rate, output_rate);
+        _up          = output_rate / divisor;
+        _down        = input_rate / divisor;
+        if (_up > 4096)
+        {
+            throw std::range_error{"resampling ratio is too fine"};
+        }
+
+        // decimating narrows the pass band, the kernel widens with it to
+        // keep the transition band as sharp relative to the output rate
+        auto [taps, beta, bandwidth] = detail::design_for(quality);
+        auto widening                = (_down + _up - 1) / _up;
+        _taps  = std::min(taps * widening, max_taps);
+        _phase = _up;
+        _history.resize(2 * _taps);
+        _coefficients.resize(_up * _taps);
+
+        // cut off relative to the up sampled rate
+        auto widest      = static_cast<double>(std::max(_up, _down));
+        auto cutoff      = bandwidth / (2 * widest);
+        auto length      = _up * _taps;
+        auto middle      = static_cast<double>(length - 1) / 2;
+        auto window_norm = detail::bessel_i0(beta);
+        std::vector<double> prototype(length);
+        for (size_t n = 0; n < length; ++n)
+        {
+            auto x    = static_cast<double>(n) - middle;
+            auto sinc = x == 0 ? 2 * cutoff
+                               : std::sin(2 * std::numbers::pi * cutoff * x) /
+                                     (std::numbers::pi * x);
+            auto ratio = x / (middle + 1);
+            prototype[n] =
+                sinc * detail::bessel_i0(beta * std::sqrt(1 - ratio * ratio)) /
+                window_norm;
+        }
+        // unity gain: every phase sums to ~1 when interpolating
+        auto sum  = std::accumulate(prototype.begin(), prototype.end(), 0.0);
+        auto gain = static_cast<double>(_up) / sum;
+        for (size_t phase = 0; phase < _up; ++phase)
+        {
+            for (size_t k = 0; k < _taps; ++k)
+            {
+                auto value        = prototype[phase + k * _up] * gain;
+                auto& coefficient = _coefficients[phase * _taps + k];
+                if constexpr (std::floating_point<CoeffT>)
+                {
+                    coefficient = static_cast<CoeffT>(value);
+                }
+                else
+                {
+                    coefficient = CoeffT{value};
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] size_t up() const noexcept
+    {
+        return _up;
+    }
+
+    [[nodiscard]] size_t down() const noexcept
+    {
+        return _down;
+    }
+
+    [[nodiscard]] size_t taps() const noexcept
+    {
+        return _taps;
+    }
+
+    // group delay in input samples
+    [[nodiscard]] double latency() const noexcept
+    {
+        return static_cast<double>(_up * _taps - 1) /
+               (2 * static_cast<double>(_up));
+    }
+
+    // samples the next process() call produces from input samples, given
+    // enough room
+    [[nodiscard]] size_t max_output(size_t input) const noexcept
+    {
+        // output t needs _phase + t * _down < _up * (input + 1)
+        auto limit = _up * (input + 1);
+        return limit <= _phase ? 0 : (limit - _phase + _down - 1) / _down;
+    }
+
+    void reset() noexcept
+    {
+        std::ranges::fill(_history, SampleT{});
+        _position = 0;
+        _phase    = _up;
+    }
+
+    // stops when input runs out or output is full
+    resample_result process(std::span<const SampleT> input,
+                            std::span<SampleT> output) noexcept
+    {
+        size_t consumed = 0;
+        size_t produced = 0;
+        while (produced < output.size())
+        {
+            while (_phase >= _up)
+            {
+                if (consumed == input.size())
+                {
+                    return {consumed, produced};
+                }
+                push(input[consumed++]);
+                _phase -= _up;
+            }
+            output[produced++] = inner_product(_phase);
+            _phase += _down;
+        }
+        return {consumed, produced};
+    }
+};
+} // namespace bit::dsp
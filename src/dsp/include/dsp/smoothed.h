@@ -0,0 +1,332 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace bit::dsp
+{
+enum class ramp_shape
+{
+    linear,
+    // one-pole like, aims slightly past the target so that it still gets
+    // there in time
+    exponential,
+};
+
+// Parameter that glides to every new target over a fixed number of samples
+// instead of stepping at a block boundary, so gain, cutoff and the like
+// change without zipper noise.
+//
+// The ramp is computed per block, not per sample: a linear one as start
+// plus index times step, an exponential one from precomputed powers of the
+// per sample coefficient, 8 lanes at a time in fixed point, the same way
+// the envelope fills its segments. Once the target is reached the value
+// snaps to it exactly and render() is a fill, apply() a constant multiply
+// or nothing at all at unity, and advance() returns right away.
+//
+// Internally the value is kept left aligned in 32 bits, so narrow formats
+// ramp with extra fraction bits.
+template <qformatted ValueQ>
+    requires(ValueQ::bits + ValueQ::is_signed <= 32)
+class smoothed
+{
+  public:
+    using value_type = ValueQ;
+
+  private:
+    using raw_type = typename ValueQ::value_type;
+
+    static constexpr size_t shift =
+        32 - (ValueQ::bits + (ValueQ::is_signed ? 1 : 0));
+    static constexpr size_t lanes = 8;
+    // of the exponential powers, so that a product with the largest
+    // distance still fits
+    static constexpr size_t power_bits = 30;
+    static constexpr int64_t one       = int64_t{1} << power_bits;
+    // -60 dB of the step is left when the exponential ramp snaps
+    static constexpr double overshoot = 0.001;
+
+    size_t _length     = 0;
+    ramp_shape _shape  = ramp_shape::linear;
+    int64_t _level     = 0;
+    int64_t _target    = 0;
+    size_t _remaining  = 0;
+    int64_t _step      = 0;
+    int64_t _asymptote = 0;
+    int64_t _distance  = 0;
+    size_t _phase      = 0;
+    // c^0 ... c^(lanes - 1) and c^lanes
+    std::array<int64_t, lanes> _powers{};
+    int64_t _stride = 0;
+
+    [[nodiscard]] static constexpr int64_t internal(ValueQ value) noexcept
+    {
+        return static_cast<int64_t>(value.raw()) * (int64_t{1} << shift);
+    }
+
+    [[nodiscard]] static constexpr raw_type external(int64_t level) noexcept
+    {
+        return static_cast<raw_type>(level >> shift);
+    }
+
+    void make_powers() noexcept
+    {
+        if (_length == 0)
+        {
+            return;
+        }
+        auto coefficient = std::pow(overshoot / (1 + overshoot),
+                                    1.0 / static_cast<double>(_length));
+        for (size_t j = 0; j < lanes; ++j)
+        {
+            _powers[j] =
+                std::llround(std::pow(coefficient, static_cast<double>(j)) *
+                             static_cast<double>(one));
+        }
+        _stride =
+            std::llround(std::pow(coefficient, static_cast<double>(lanes)) *
+                         static_cast<double>(one));
+    }
+
+    template <qformatted SampleQ>
+    static void multiply(SampleQ& sample, int64_t gain) noexcept
+    {
+        using limits     = std::numeric_limits<SampleQ>;
+        using sample_raw = typename SampleQ::value_type;
+        constexpr auto lowest  = static_cast<int64_t>(limits::lowest().raw());
+        constexpr auto highest = static_cast<int64_t>(limits::max().raw());
+        auto product     = (static_cast<int64_t>(sample.raw()) * gain) >>
+                       ValueQ::fraction_bits;
+        sample = {as_is_t{
+            static_cast<sample_raw>(std::clamp(product, lowest, highest))}};
+    }
+
+    // count samples of the ramp, count no more than remaining
+    template <typename SinkT> void ramp(SinkT& sink, size_t count) noexcept
+    {
+        size_t i = 0;
+        if (_shape == ramp_shape::linear)
+        {
+            // lane offsets, so that the loop only adds
+            std::array<int64_t, lanes> offsets{};
+            for (size_t j = 0; j < lanes; ++j)
+            {
+                offsets[j] = static_cast<int64_t>(j) * _step;
+            }
+            auto stride = static_cast<int64_t>(lanes) * _step;
+            auto level  = _level;
+            for (; i + lanes <= count; i += lanes)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    sink(i + j, level + offsets[j]);
+                }
+                level += stride;
+            }
+            for (size_t j = 0; i + j < count; ++j)
+            {
+                sink(i + j, level + offsets[j]);
+            }
+            _level = level + offsets[count - i];
+        }
+        else
+        {
+            // distance is the one at the start of the current group of
+            // lanes, so the ramp is the same whatever the block size
+            auto distance = _distance;
+            auto phase    = _phase;
+            auto value    = [&](size_t lane) {
+                return _asymptote + ((distance * _powers[lane]) >> power_bits);
+            };
+            for (; phase != 0 and i < count; ++i)
+            {
+                sink(i, value(phase));
+                if (++phase == lanes)
+                {
+                    phase    = 0;
+                    distance = (distance * _stride) >> power_bits;
+                }
+            }
+            for (; i + lanes <= count; i += lanes)
+            {
+                for (size_t j = 0; j < lanes; ++j)
+                {
+                    sink(i + j, value(j));
+                }
+                distance = (distance * _stride) >> power_bits;
+            }
+            if (i < count)
+            {
+                for (phase = 0; i < count; ++i, ++phase)
+                {
+                    sink(i, value(phase));
+                }
+            }
+            _distance = distance;
+            _phase    = phase;
+            _level    = value(phase);
+        }
+
+        _remaining -= count;
+        if (_remaining == 0)
+        {
+            // snap away the ramp rounding
+            _level = _target;
+        }
+    }
+
+    void glide(int64_t target) noexcept
+    {
+        _target = target;
+        if (_length == 0 or _target == _level)
+        {
+            _level     = _target;
+            _remaining = 0;
+            return;
+        }
+        _remaining = _length;
+        if (_shape == ramp_shape::linear)
+        {
+            _step = (_target - _level) / static_cast<int64_t>(_length);
+        }
+        else
+        {
+            auto height = static_cast<double>(_target - _level);
+            _asymptote  = _target + std::llround(height * overshoot);
+            _distance   = _level - _asymptote;
+            _phase      = 0;
+        }
+    }
+
+    // the ramp first, then the settled value for the rest of the block
+    template <typename SinkT> void process(size_t size, SinkT& sink) noexcept
+    {
+        size_t index = 0;
+        if (_remaining > 0)
+        {
+            index = std::min(size, _remaining);
+            ramp(sink, index);
+        }
+        for (size_t i = index; i < size; ++i)
+        {
+            sink(i, _level);
+        }
+    }
+
+  public:
+    explicit smoothed(ValueQ initial = {},
+                      size_t length  = 0,
+                      ramp_shape shape = ramp_shape::linear) noexcept
+        : _level{internal(initial)}, _target{_level}
+    {
+        set_ramp(length, shape);
+    }
+
+    // samples a change takes; a ramp in progress starts over with it
+    void set_ramp(size_t length, ramp_shape shape) noexcept
+    {
+        _length = length;
+        _shape  = shape;
+        make_powers();
+        if (_remaining > 0)
+        {
+            glide(_target);
+        }
+    }
+
+    // glides from the current value, also in the middle of a ramp
+    void set_target(ValueQ target) noexcept
+    {
+        glide(internal(target));
+    }
+
+    // without a ramp
+    void jump(ValueQ value) noexcept
+    {
+        _target    = internal(value);
+        _level     = _target;
+        _remaining = 0;
+    }
+
+    [[nodiscard]] bool is_smoothing() const noexcept
+    {
+        return _remaining > 0;
+    }
+
+    [[nodiscard]] ValueQ current() const noexcept
+    {
+        return {as_is_t{external(_level)}};
+    }
+
+    [[nodiscard]] ValueQ target() const noexcept
+    {
+        return {as_is_t{external(_target)}};
+    }
+
+    // moves the ramp on by frames samples without producing them, for
+    // parameters used once per block such as filter coefficients
+    void advance(size_t frames) noexcept
+    {
+        if (_remaining == 0)
+        {
+            return;
+        }
+        auto count = std::min(frames, _remaining);
+        if (_shape == ramp_shape::linear)
+        {
+            _level += static_cast<int64_t>(count) * _step;
+            _remaining -= count;
+            if (_remaining == 0)
+            {
+                _level = _target;
+            }
+            return;
+        }
+        auto skip = [](size_t, int64_t) {};
+        ramp(skip, count);
+    }
+
+    // the value at every sample of the block
+    void render(std::span<ValueQ> block) noexcept
+    {
+        if (_remaining == 0)
+        {
+            std::ranges::fill(block, current());
+            return;
+        }
+        auto sink = [block](size_t i, int64_t level) {
+            block[i] = {as_is_t{external(level)}};
+        };
+        process(block.size(), sink);
+    }
+
+    // multiplies every channel by the value, e.g. as a gain, saturating
+    template <qformatted... SampleQ>
+        requires(((SampleQ::bits + SampleQ::is_signed + ValueQ::bits +
+                   ValueQ::is_signed) <= 63) and
+                 ...)
+    void apply(std::span<SampleQ>... channels) noexcept
+    {
+        static_assert(sizeof...(SampleQ) > 0);
+        auto size = std::min({channels.size()...});
+        if (_remaining == 0 and
+            _level == (int64_t{1} << (ValueQ::fraction_bits + shift)))
+        {
+            return;
+        }
+        auto sink = [&](size_t i, int64_t level) {
+            auto gain = static_cast<int64_t>(external(level));
+            (multiply(channels[i], gain), ...);
+        };
+        process(size, sink);
+    }
+};
+} // namespace bit::dsp
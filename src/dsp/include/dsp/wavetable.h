@@ -0,0 +1,256 @@
+#pragma once
+
+#include "dsp/phase.h"
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace bit::dsp
+{
+// Band-limited mip-mapped single cycle tables. Level k keeps the harmonics up
+// to TableSize / 4 >> k, one octave less than the level before, so the table
+// is at least 2x oversampled and a level played at increments below
+// 1 / (2 * max_harmonic(k)) doesn't alias. Every level is stored as TableSize
+// + 1 TableQ samples, the last one repeating the first so that interpolation
+// never wraps.
+//
+// Building computes a DFT and is meant to happen once, off the audio thread;
+// the result is read-only and shared by every voice playing it.
+template <qformatted TableQ, size_t TableSize = 2048>
+    requires(std::has_single_bit(TableSize) and TableSize >= 8 and
+             TableSize <= (1 << 17) and TableQ::is_signed)
+class wavetable
+{
+  public:
+    using sample_type = TableQ;
+
+    static constexpr size_t size   = TableSize;
+    static constexpr size_t levels = std::bit_width(TableSize / 4);
+
+    [[nodiscard]] static constexpr size_t max_harmonic(size_t level) noexcept
+    {
+        return (TableSize / 4) >> level;
+    }
+
+    // lowest level whose harmonics stay below Nyquist at increment
+    [[nodiscard]] static constexpr size_t level_for(
+        phase_type increment) noexcept
+    {
+        auto highest = (uint64_t{increment.raw()} * max_harmonic(0)) >> 31;
+        return std::min<size_t>(std::bit_width(highest), levels - 1);
+    }
+
+  private:
+    std::vector<TableQ> _samples;
+
+    struct spectrum
+    {
+        std::vector<double> cosines;
+        std::vector<double> sines;
+    };
+
+    explicit wavetable(const spectrum& harmonics)
+        : _samples(levels * (TableSize + 1))
+    {
+        std::vector<double> cosine(TableSize);
+        std::vector<double> sine(TableSize);
+        for (size_t i = 0; i < TableSize; ++i)
+        {
+            auto angle = 2 * std::numbers::pi * static_cast<double>(i) /
+                         static_cast<double>(TableSize);
+            cosine[i] = std::cos(angle);
+            sine[i]   = std::sin(angle);
+        }
+
+        std::vector<double> synthesized(levels * TableSize);
+        double peak = 0;
+        for (size_t level = 0; level < levels; ++level)
+        {
+            auto count = std::min(max_harmonic(level), harmonics.sines.size());
+            auto table = std::span{synthesized}.subspan(level * TableSize,
+                                                        TableSize);
+            for (size_t i = 0; i < TableSize; ++i)
+            {
+                double sum = 0;
+                for (size_t h = 1; h <= count; ++h)
+                {
+                    auto index = (h * i) & (TableSize - 1);
+                    sum += harmonics.cosines[h - 1] * cosine[index] +
+                           harmonics.sines[h - 1] * sine[index];
+                }
+                table[i] = sum;
+                peak     = std::max(peak, std::abs(sum));
+            }
+        }
+        if (peak == 0)
+        {
+            throw std::runtime_error{"wavetable has no harmonics"};
+        }
+
+        // one gain for every level, so the loudness doesn't jump with pitch
+        auto gain = std::numeric_limits<TableQ>::max().template as<double>() /
+                    peak;
+        for (size_t level = 0; level < levels; ++level)
+        {
+            for (size_t i = 0; i <= TableSize; ++i)
+            {
+                auto value = synthesized[level * TableSize + i % TableSize];
+                _samples[level * (TableSize + 1) + i] = TableQ{value * gain};
+            }
+        }
+    }
+
+  public:
+    // sine amplitudes of harmonics 1, 2, ...
+    [[nodiscard]] static wavetable from_harmonics(
+        std::span<const double> amplitudes)
+    {
+        auto count = std::min(amplitudes.size(), max_harmonic(0));
+        spectrum harmonics{std::vector<double>(count),
+                           {amplitudes.begin(), amplitudes.begin() + count}};
+        return wavetable{harmonics};
+    }
+
+    // single cycle of any length, band-limited by a DFT
+    [[nodiscard]] static wavetable from_cycle(std::span<const double> cycle)
+    {
+        if (cycle.size() < 2)
+        {
+            throw std::range_error{"cycle needs at least two samples"};
+        }
+        auto count = std::min(cycle.size() / 2, max_harmonic(0));
+        spectrum harmonics{std::vector<double>(count),
+                           std::vector<double>(count)};
+        auto length = static_cast<double>(cycle.size());
+        std::vector<double> cosine(cycle.size());
+        std::vector<double> sine(cycle.size());
+        for (size_t i = 0; i < cycle.size(); ++i)
+        {
+            auto angle = 2 * std::numbers::pi * static_cast<double>(i) / length;
+            cosine[i]  = std::cos(angle);
+            sine[i]    = std::sin(angle);
+        }
+        for (size_t h = 1; h <= count; ++h)
+        {
+            for (size_t i = 0; i < cycle.size(); ++i)
+            {
+                auto index = (h * i) % cycle.size();
+                harmonics.cosines[h - 1] += cycle[i] * cosine[index];
+                harmonics.sines[h - 1] += cycle[i] * sine[index];
+            }
+            // Nyquist bin of an even cycle is real and counted once
+            auto scale = 2 * h == cycle.size() ? 1 / length : 2 / length;
+            harmonics.cosines[h - 1] *= scale;
+            harmonics.sines[h - 1] *= scale;
+        }
+        return wavetable{harmonics};
+    }
+
+    [[nodiscard]] std::span<const TableQ, TableSize + 1> level(
+        size_t index) const noexcept
+    {
+        assert(index < levels);
+        return std::span<const TableQ, TableSize + 1>{
+            _samples.data() + index * (TableSize + 1), TableSize + 1};
+    }
+};
+
+// Plays a shared wavetable, which has to outlive it. The level is picked
+// when the increment changes; per sample it's a phase add, two loads and a
+// fixed point linear interpolation.
+template <typename WavetableT> class wavetable_oscillator
+{
+  public:
+    using sample_type = typename WavetableT::sample_type;
+
+  private:
+    using value_type = typename sample_type::value_type;
+    // difference of two samples times a Q0.15 fraction
+    using compute_type = std::
+        conditional_t<(sample_type::bits + 2 + 15 <= 32), int32_t, int64_t>;
+
+    static constexpr size_t index_shift =
+        32 - std::bit_width(WavetableT::size - 1);
+    static constexpr size_t fraction_shift = index_shift - 15;
+
+    const WavetableT* _table;
+    const sample_type* _level;
+    phase_type _phase{};
+    phase_type _increment{};
+
+  public:
+    explicit wavetable_oscillator(const WavetableT& table,
+                                  phase_type increment = {},
+                                  phase_type phase     = {}) noexcept
+        : _table{&table}, _level{table.level(0).data()}, _phase{phase}
+    {
+        set_increment(increment);
+    }
+
+    void set_increment(phase_type increment) noexcept
+    {
+        _increment = increment;
+        _level = _table->level(WavetableT::level_for(increment)).data();
+    }
+
+    void set_phase(phase_type phase) noexcept
+    {
+        _phase = phase;
+    }
+
+    [[nodiscard]] phase_type phase() const noexcept
+    {
+        return _phase;
+    }
+
+    [[nodiscard]] phase_type increment() const noexcept
+    {
+        return _increment;
+    }
+
+    [[nodiscard]] size_t level() const noexcept
+    {
+        return WavetableT::level_for(_increment);
+    }
+
+    void render(std::span<sample_type> block) noexcept
+    {
+        const auto phase     = _phase.raw();
+        const auto increment = _increment.raw();
+        const auto* table    = _level;
+
+        for (size_t i = 0; i < block.size(); ++i)
+        {
+            auto t = static_cast<uint32_t>(phase + static_cast<uint32_t>(i) *
+                                                       increment);
+            auto index    = t >> index_shift;
+            auto fraction = static_cast<compute_type>(
+                (t >> fraction_shift) & ((1u << 15) - 1));
+            auto from = static_cast<compute_type>(table[index].raw());
+            auto to   = static_cast<compute_type>(table[index + 1].raw());
+            block[i]  = {as_is_t{static_cast<value_type>(
+                from + (((to - from) * fraction) >> 15))}};
+        }
+        _phase = {as_is_t{static_cast<uint32_t>(
+            phase + static_cast<uint32_t>(block.size()) * increment)}};
+    }
+
+    [[nodiscard]] sample_type next() noexcept
+    {
+        sample_type sample{};
+        render(std::span{&sample, 1});
+        return sample;
+    }
+};
+} // namespace bit::dsp
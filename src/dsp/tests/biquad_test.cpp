@@ -0,0 +1,229 @@
+#include <dsp/biquad.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type      = bit::qs<0, 15>;
+using coefficient_type = bit::qs<1, 14>;
+
+// computed at compile time
+constexpr std::array<bit::dsp::biquad_coefficients<coefficient_type>, 2>
+    lowpass_sections{bit::dsp::lowpass_biquad<coefficient_type>(0.05),
+                     bit::dsp::lowpass_biquad<coefficient_type>(0.05)};
+
+std::vector<sample_type> noise(size_t size)
+{
+    std::mt19937 generator{};
+    std::uniform_int_distribution<int> distribution(-8192, 8191);
+    std::vector<sample_type> samples(size);
+    for (auto& sample : samples)
+    {
+        sample = bit::as_is_t{static_cast<int16_t>(distribution(generator))};
+    }
+    return samples;
+}
+
+double rms(std::span<const sample_type> samples)
+{
+    double sum = 0;
+    for (auto sample : samples)
+    {
+        sum += sample.as<double>() * sample.as<double>();
+    }
+    return std::sqrt(sum / static_cast<double>(samples.size()));
+}
+
+std::vector<sample_type> sine(size_t size, double frequency, double amplitude)
+{
+    std::vector<sample_type> samples(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        samples[i] = sample_type{
+            amplitude * std::sin(2 * std::numbers::pi * frequency *
+                                 static_cast<double>(i))};
+    }
+    return samples;
+}
+} // namespace
+
+TEST_CASE("biquad matches double precision reference", "[dsp|biquad]")
+{
+    constexpr auto coefficients =
+        bit::dsp::lowpass_biquad<bit::qs<1, 30>>(0.1, 2.0);
+    bit::dsp::biquad_cascade<bit::qs<1, 30>, bit::qs<0, 31>, 1> filter{
+        {coefficients}};
+    std::vector<bit::qs<0, 31>> block(512);
+    std::vector<double> reference(block.size());
+    std::mt19937 generator{};
+    std::uniform_real_distribution<double> distribution(-0.25, 0.25);
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        block[i]     = bit::qs<0, 31>{distribution(generator)};
+        reference[i] = block[i].as<double>();
+    }
+
+    auto b0 = coefficients.b0.as<double>();
+    auto b1 = coefficients.b1.as<double>();
+    auto b2 = coefficients.b2.as<double>();
+    auto a1 = coefficients.a1.as<double>();
+    auto a2 = coefficients.a2.as<double>();
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    for (auto& sample : reference)
+    {
+        auto y = b0 * sample + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        x2     = std::exchange(x1, sample);
+        y2     = std::exchange(y1, y);
+        sample = y;
+    }
+
+    filter.process(std::span{block.begin(), 200});
+    filter.process(std::span{block.begin() + 200, block.end()});
+
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        INFO("Sample: " << i);
+        REQUIRE(std::abs(block[i].as<double>() - reference[i]) < 1e-8);
+    }
+}
+
+TEST_CASE("lowpass cascade passes DC and stops Nyquist", "[dsp|biquad]")
+{
+    bit::dsp::biquad_cascade<coefficient_type, sample_type, 2> filter{
+        lowpass_sections};
+    std::vector<sample_type> dc(512, sample_type{0.5f});
+    filter.process(dc);
+    CHECK(std::abs(dc.back().as<float>() - 0.5f) < 2e-3f);
+
+    filter.reset();
+    std::vector<sample_type> nyquist(512);
+    for (size_t i = 0; i < nyquist.size(); ++i)
+    {
+        nyquist[i] = sample_type{i % 2 ? 0.5f : -0.5f};
+    }
+    filter.process(nyquist);
+    CHECK(std::abs(nyquist.back().as<float>()) < 2e-3f);
+}
+
+TEST_CASE("highpass biquad stops DC", "[dsp|biquad]")
+{
+    bit::dsp::biquad_cascade<coefficient_type, sample_type, 1> filter{
+        {bit::dsp::highpass_biquad<coefficient_type>(0.01)}};
+    std::vector<sample_type> dc(4096, sample_type{0.5f});
+    filter.process(dc);
+    CHECK(std::abs(dc.back().as<float>()) < 1e-3f);
+}
+
+TEST_CASE("error feedback lowers noise of a low cutoff section",
+          "[dsp|biquad]")
+{
+    // 200 Hz at 48 kHz with 16-bit coefficients, poles close to z = 1
+    constexpr auto coefficients =
+        bit::dsp::lowpass_biquad<coefficient_type>(200.0 / 48000.0);
+    auto input = sine(48000, 100.0 / 48000.0, 0.25);
+
+    auto filtered = [&]<bool ErrorFeedback>(
+                        std::bool_constant<ErrorFeedback>) {
+        bit::dsp::
+            biquad_cascade<coefficient_type, sample_type, 1, ErrorFeedback>
+                filter{{coefficients}};
+        auto block = input;
+        filter.process(block);
+        return block;
+    };
+    auto with_feedback    = filtered(std::true_type{});
+    auto without_feedback = filtered(std::false_type{});
+
+    // same filter run in double precision
+    std::vector<double> reference(input.size());
+    double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        auto x = input[i].as<double>();
+        auto y = coefficients.b0.as<double>() * x +
+                 coefficients.b1.as<double>() * x1 +
+                 coefficients.b2.as<double>() * x2 -
+                 coefficients.a1.as<double>() * y1 -
+                 coefficients.a2.as<double>() * y2;
+        x2           = std::exchange(x1, x);
+        y2           = std::exchange(y1, y);
+        reference[i] = y;
+    }
+    auto error_rms = [&](const std::vector<sample_type>& output) {
+        double sum = 0;
+        for (size_t i = 0; i < output.size(); ++i)
+        {
+            auto error = output[i].as<double>() - reference[i];
+            sum += error * error;
+        }
+        return std::sqrt(sum / static_cast<double>(output.size()));
+    };
+
+    CHECK(error_rms(with_feedback) < 4.0 / 32768);
+    CHECK(error_rms(with_feedback) * 100 < error_rms(without_feedback));
+
+    // and it doesn't get stuck away from zero once the input stops
+    std::vector<sample_type> silence(48000, sample_type{0.f});
+    bit::dsp::biquad_cascade<coefficient_type, sample_type, 1> filter{
+        {coefficients}};
+    auto block = input;
+    filter.process(block);
+    filter.process(silence);
+    CHECK(rms(std::span{silence}.last(4800)) == 0);
+}
+
+TEST_CASE("biquad cascade throughput", "[.benchmark][dsp|biquad]")
+{
+    auto input = noise(4096);
+    std::vector<sample_type> block(input.size());
+    std::array<bit::dsp::biquad_coefficients<coefficient_type>, 8> sections;
+    std::ranges::fill(sections,
+                      bit::dsp::lowpass_biquad<coefficient_type>(0.1));
+    bit::dsp::biquad_cascade<coefficient_type, sample_type, 8> filter{
+        sections};
+
+    std::vector<float> float_block(input.size());
+    std::array<float, 5> float_coefficients{sections[0].b0.as<float>(),
+                                            sections[0].b1.as<float>(),
+                                            sections[0].b2.as<float>(),
+                                            sections[0].a1.as<float>(),
+                                            sections[0].a2.as<float>()};
+    std::array<std::array<float, 4>, 8> float_states{};
+
+    BENCHMARK("fixed point, 8 sections x 4096 samples")
+    {
+        std::ranges::copy(input, block.begin());
+        filter.process(block);
+        return block.back();
+    };
+
+    BENCHMARK("float, 8 sections x 4096 samples")
+    {
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            float_block[i] = input[i].as<float>();
+        }
+        auto [b0, b1, b2, a1, a2] = float_coefficients;
+        for (auto& state : float_states)
+        {
+            auto [x1, x2, y1, y2] = state;
+            for (auto& sample : float_block)
+            {
+                auto y = b0 * sample + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+                x2     = std::exchange(x1, sample);
+                y2     = std::exchange(y1, y);
+                sample = y;
+            }
+            state = {x1, x2, y1, y2};
+        }
+        return float_block.back();
+    };
+}
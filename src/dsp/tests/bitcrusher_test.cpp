@@ -0,0 +1,200 @@
+#include <dsp/bitcrusher.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type = bit::qs<0, 15>;
+
+std::vector<sample_type> noise(size_t size)
+{
+    std::mt19937 generator{};
+    std::uniform_int_distribution<int> distribution(-32768, 32767);
+    std::vector<sample_type> samples(size);
+    for (auto& sample : samples)
+    {
+        sample = bit::as_is_t{static_cast<int16_t>(distribution(generator))};
+    }
+    return samples;
+}
+
+// lengths of runs of equal consecutive samples
+std::vector<size_t> runs(std::span<const sample_type> samples)
+{
+    std::vector<size_t> lengths{1};
+    for (size_t i = 1; i < samples.size(); ++i)
+    {
+        if (samples[i] == samples[i - 1])
+        {
+            ++lengths.back();
+        }
+        else
+        {
+            lengths.push_back(1);
+        }
+    }
+    return lengths;
+}
+} // namespace
+
+TEST_CASE("bitcrusher at full depth changes nothing", "[dsp|bitcrusher]")
+{
+    auto input = noise(1000);
+    auto block = input;
+    bit::dsp::bitcrusher<sample_type> crusher{};
+    crusher.process(block);
+    REQUIRE(block == input);
+}
+
+TEST_CASE("bitcrusher mask mode drops low bits", "[dsp|bitcrusher]")
+{
+    auto input = noise(1000);
+    auto block = input;
+    bit::dsp::bitcrusher<sample_type> crusher{4};
+    crusher.process(block);
+
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        INFO("Sample: " << i);
+        REQUIRE(block[i].raw() % 4096 == 0);
+        REQUIRE(block[i].raw() <= input[i].raw());
+        REQUIRE(input[i].raw() - block[i].raw() < 4096);
+    }
+}
+
+TEST_CASE("bitcrusher round mode rounds to nearest level", "[dsp|bitcrusher]")
+{
+    auto input = noise(1000);
+    input.push_back(std::numeric_limits<sample_type>::max());
+    input.push_back(std::numeric_limits<sample_type>::lowest());
+    auto block = input;
+    bit::dsp::bitcrusher<sample_type> crusher{
+        4, 1, bit::dsp::crush_mode::round};
+    crusher.process(block);
+
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        INFO("Sample: " << i);
+        REQUIRE(block[i].raw() % 4096 == 0);
+        // except above the top level, which can't round up
+        REQUIRE((std::abs(input[i].raw() - block[i].raw()) <= 2048 or
+                 block[i].raw() == 28672));
+    }
+    CHECK(block[block.size() - 2].raw() == 28672);
+    CHECK(block.back().raw() == -32768);
+}
+
+TEST_CASE("bitcrusher depth steps towards target within one block",
+          "[dsp|bitcrusher]")
+{
+    bit::dsp::bitcrusher<sample_type> crusher{};
+    crusher.set_depth(4);
+    constexpr auto max = std::numeric_limits<sample_type>::max();
+    std::vector<sample_type> block(120, max);
+    crusher.process(block);
+
+    // 16 -> 4 in 13 runs of about 120 / 13 samples
+    auto lengths = runs(block);
+    REQUIRE(lengths.size() == 13);
+    for (auto length : lengths)
+    {
+        CHECK((length == 9 or length == 10));
+    }
+    for (size_t i = 1; i < block.size(); ++i)
+    {
+        REQUIRE(block[i].raw() <= block[i - 1].raw());
+    }
+    CHECK(block.back().raw() == 0x7000);
+
+    std::vector<sample_type> next(64, max);
+    crusher.process(next);
+    CHECK(runs(next).size() == 1);
+    CHECK(next.front().raw() == 0x7000);
+}
+
+TEST_CASE("bitcrusher holds samples across blocks", "[dsp|bitcrusher]")
+{
+    auto input = noise(1000);
+    auto block = input;
+    bit::dsp::bitcrusher<sample_type> crusher{16, 4};
+    crusher.process(std::span{block}.first(333));
+    crusher.process(std::span{block}.subspan(333));
+
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        INFO("Sample: " << i);
+        REQUIRE(block[i] == input[i - i % 4]);
+    }
+}
+
+TEST_CASE("bitcrusher jitter varies held periods reproducibly",
+          "[dsp|bitcrusher]")
+{
+    auto input = noise(4096);
+    auto crushed = [&](uint32_t seed) {
+        auto block = input;
+        bit::dsp::bitcrusher<sample_type> crusher{16, 8};
+        crusher.set_jitter(3, seed);
+        crusher.process(block);
+        return block;
+    };
+
+    auto block   = crushed(1);
+    auto lengths = runs(block);
+    lengths.pop_back(); // cut by the block end
+    size_t shortest = 100, longest = 0;
+    for (auto length : lengths)
+    {
+        shortest = std::min(shortest, length);
+        longest  = std::max(longest, length);
+    }
+    CHECK(shortest == 5);
+    CHECK(longest == 11);
+    CHECK(crushed(1) == block);
+    CHECK(crushed(2) != block);
+}
+
+TEST_CASE("bitcrusher throughput", "[.benchmark][dsp|bitcrusher]")
+{
+    auto input = noise(4096);
+    auto block = input;
+    bit::dsp::bitcrusher<sample_type> crusher{
+        8, 1, bit::dsp::crush_mode::round};
+    size_t depth = 8;
+
+    BENCHMARK("fixed depth, 4096 samples")
+    {
+        block = input;
+        crusher.process(block);
+        return block.back();
+    };
+
+    BENCHMARK("modulated depth, 64 blocks of 64 samples")
+    {
+        block = input;
+        for (size_t i = 0; i < block.size(); i += 64)
+        {
+            depth = depth == 3 ? 12 : depth - 1;
+            crusher.set_depth(depth);
+            crusher.process(std::span{block}.subspan(i, 64));
+        }
+        return block.back();
+    };
+
+    BENCHMARK("sample and hold by 4, 4096 samples")
+    {
+        block = input;
+        crusher.set_hold(4);
+        crusher.process(block);
+        crusher.set_hold(1);
+        return block.back();
+    };
+}
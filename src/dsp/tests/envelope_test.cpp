@@ -0,0 +1,191 @@
+#include <dsp/envelope.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using level_type = bit::dsp::adsr::level_type;
+
+constexpr bit::dsp::adsr_parameters linear{
+    .attack = 100, .decay = 100, .sustain = level_type{0.5}, .release = 50};
+
+constexpr bit::dsp::adsr_parameters exponential{
+    .attack        = 100,
+    .decay         = 100,
+    .sustain       = level_type{0.5},
+    .release       = 50,
+    .attack_curve  = bit::dsp::envelope_curve::exponential,
+    .decay_curve   = bit::dsp::envelope_curve::exponential,
+    .release_curve = bit::dsp::envelope_curve::exponential};
+
+// trigger at 10, release at 300, rendered in blocks of block_size
+std::vector<double> render(const bit::dsp::adsr_parameters& parameters,
+                           size_t block_size,
+                           size_t size = 400)
+{
+    bit::dsp::adsr envelope{parameters};
+    envelope.trigger(10);
+    envelope.release(300);
+    std::vector<level_type> levels(size);
+    for (size_t i = 0; i < size; i += block_size)
+    {
+        envelope.render(
+            std::span{levels}.subspan(i, std::min(block_size, size - i)));
+    }
+    std::vector<double> result(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        result[i] = levels[i].as<double>();
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("linear adsr follows its segments sample accurately",
+          "[dsp|envelope]")
+{
+    auto levels = render(linear, 64);
+
+    CHECK(levels[9] == 0);
+    CHECK(levels[10] == 0);
+    CHECK(std::abs(levels[60] - 0.5) < 1e-6);
+    CHECK(levels[110] == 1.0);
+    CHECK(std::abs(levels[160] - 0.75) < 1e-6);
+    CHECK(levels[210] == 0.5);
+    CHECK(levels[299] == 0.5);
+    CHECK(levels[300] == 0.5);
+    CHECK(std::abs(levels[325] - 0.25) < 1e-6);
+    CHECK(levels[350] == 0);
+    CHECK(levels.back() == 0);
+}
+
+TEST_CASE("adsr output doesn't depend on the block size", "[dsp|envelope]")
+{
+    for (const auto& parameters : {linear, exponential})
+    {
+        auto expected = render(parameters, 400);
+        for (size_t block_size : {1, 7, 64})
+        {
+            auto levels = render(parameters, block_size);
+            for (size_t i = 0; i < levels.size(); ++i)
+            {
+                INFO("Block size: " << block_size << " sample: " << i);
+                REQUIRE(std::abs(levels[i] - expected[i]) < 1e-6);
+            }
+        }
+    }
+}
+
+TEST_CASE("exponential adsr segments end on their levels", "[dsp|envelope]")
+{
+    auto levels = render(exponential, 64);
+
+    CHECK(levels[10] == 0);
+    CHECK(levels[110] == 1.0);
+    CHECK(levels[210] == 0.5);
+    CHECK(levels[350] == 0);
+    // RC like: attack bows up, decay and release fall fast first
+    CHECK(levels[60] > 0.5);
+    CHECK(levels[160] < 0.75);
+    CHECK(levels[325] < 0.25);
+    for (size_t i = 11; i < 110; ++i)
+    {
+        REQUIRE(levels[i] > levels[i - 1]);
+    }
+    for (size_t i = 111; i < 210; ++i)
+    {
+        REQUIRE(levels[i] < levels[i - 1]);
+    }
+}
+
+TEST_CASE("adsr releases and retriggers from the current level",
+          "[dsp|envelope]")
+{
+    bit::dsp::adsr envelope{linear};
+    envelope.trigger();
+    envelope.release(50);
+    envelope.trigger(60);
+    std::vector<level_type> levels(200);
+    envelope.render(levels);
+
+    CHECK(std::abs(levels[50].as<double>() - 0.5) < 1e-6);
+    CHECK(std::abs(levels[55].as<double>() - 0.45) < 1e-6);
+    // attack continues from 0.4 to 1 in 100 samples
+    CHECK(std::abs(levels[60].as<double>() - 0.4) < 1e-6);
+    CHECK(std::abs(levels[110].as<double>() - 0.7) < 1e-6);
+    CHECK(levels[160].as<double>() == 1.0);
+    CHECK(envelope.is_active());
+}
+
+TEST_CASE("adsr merges events at one offset once its queue is full",
+          "[dsp|envelope]")
+{
+    bit::dsp::adsr envelope{linear};
+    for (size_t i = 0; i < 3 * bit::dsp::adsr::max_events; ++i)
+    {
+        REQUIRE(envelope.release());
+        REQUIRE(envelope.trigger());
+    }
+    std::vector<level_type> levels(100);
+    envelope.render(levels);
+    // the last event, a trigger, wins
+    CHECK(std::abs(levels[50].as<double>() - 0.5) < 1e-6);
+
+    bit::dsp::adsr spread{linear};
+    for (size_t i = 0; i < bit::dsp::adsr::max_events; ++i)
+    {
+        REQUIRE(spread.trigger(i));
+    }
+    REQUIRE(not spread.release(50));
+    REQUIRE(spread.trigger(bit::dsp::adsr::max_events - 1));
+    spread.render(levels);
+    CHECK(levels[99].as<double>() > 0.9);
+}
+
+TEST_CASE("adsr applies as the voice gain", "[dsp|envelope]")
+{
+    bit::dsp::adsr envelope{linear};
+    envelope.trigger();
+    std::vector<bit::qs<0, 15>> block(128, bit::qs<0, 15>{-0.5});
+    envelope.apply(std::span{block});
+
+    CHECK(block[0].as<double>() == 0);
+    CHECK(block[50].as<double>() == -0.25);
+    CHECK(block[100].as<double>() == -0.5);
+}
+
+TEST_CASE("adsr throughput", "[.benchmark][dsp|envelope]")
+{
+    std::vector<level_type> block(64);
+
+    for (const auto& [name, parameters] :
+         {std::pair{"linear", linear}, std::pair{"exponential", exponential}})
+    {
+        auto slow    = parameters;
+        slow.attack  = 1000;
+        slow.decay   = 2000;
+        slow.release = 2000;
+        bit::dsp::adsr envelope{slow};
+        BENCHMARK(std::string{name} + ", 64 blocks of 64 samples")
+        {
+            envelope.reset();
+            envelope.trigger(3);
+            for (size_t i = 0; i < 64; ++i)
+            {
+                if (i == 48)
+                {
+                    envelope.release(5);
+                }
+                envelope.render(block);
+            }
+            return block.back();
+        };
+    }
+}
@@ -0,0 +1,157 @@
+#include <dsp/fir.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type      = bit::qs<0, 15>;
+using coefficient_type = bit::qs<1, 14>;
+
+constexpr auto coefficients = bit::dsp::lowpass<coefficient_type, 32>(0.125);
+
+std::vector<sample_type> noise(size_t size)
+{
+    std::mt19937 generator{};
+    std::uniform_int_distribution<int> distribution(-16384, 16383);
+    std::vector<sample_type> samples(size);
+    for (auto& sample : samples)
+    {
+        sample = bit::as_is_t{static_cast<int16_t>(distribution(generator))};
+    }
+    return samples;
+}
+} // namespace
+
+TEST_CASE("fir impulse response equals coefficients", "[dsp|fir]")
+{
+    bit::dsp::fir<coefficient_type, sample_type, 32, bit::qs<1, 29>> filter{
+        coefficients};
+    std::vector<sample_type> impulse(32, sample_type{0.f});
+    impulse.front() = std::numeric_limits<sample_type>::lowest();
+    std::vector<bit::qs<1, 29>> response(impulse.size());
+
+    filter.process(std::span<const sample_type>{impulse}, std::span{response});
+
+    for (size_t k = 0; k < coefficients.size(); ++k)
+    {
+        INFO("Tap: " << k);
+        REQUIRE(response[k].as<double>() == -coefficients[k].as<double>());
+    }
+}
+
+TEST_CASE("lowpass fir passes DC and stops Nyquist", "[dsp|fir]")
+{
+    bit::dsp::fir<coefficient_type, sample_type, 32> filter{coefficients};
+    std::vector<sample_type> dc(256, sample_type{0.5f});
+    std::vector<sample_type> nyquist(256);
+    for (size_t i = 0; i < nyquist.size(); ++i)
+    {
+        nyquist[i] = sample_type{i % 2 ? 0.5f : -0.5f};
+    }
+    std::vector<sample_type> output(256);
+
+    filter.process(std::span<const sample_type>{dc}, std::span{output});
+    CHECK(std::abs(output.back().as<float>() - 0.5f) < 1e-3f);
+
+    filter.reset();
+    filter.process(std::span<const sample_type>{nyquist}, std::span{output});
+    CHECK(std::abs(output.back().as<float>()) < 1e-3f);
+}
+
+TEST_CASE("fir_decimator keeps every Factor-th fir output", "[dsp|fir]")
+{
+    auto input = noise(1000);
+    std::vector<sample_type> full(input.size());
+    bit::dsp::fir<coefficient_type, sample_type, 32>{coefficients}.process(
+        std::span<const sample_type>{input}, std::span{full});
+
+    bit::dsp::fir_decimator<coefficient_type, sample_type, 32, 4> decimator{
+        coefficients};
+    std::vector<sample_type> decimated(input.size() / 4 + 1);
+    auto written = decimator.process(
+        std::span<const sample_type>{input}.first(501), std::span{decimated});
+    written += decimator.process(
+        std::span<const sample_type>{input}.subspan(501),
+        std::span{decimated}.subspan(written));
+
+    REQUIRE(written == 250);
+    for (size_t i = 0; i < written; ++i)
+    {
+        REQUIRE(decimated[i] == full[i * 4]);
+    }
+}
+
+TEST_CASE("fir_interpolator equals fir over zero stuffed input", "[dsp|fir]")
+{
+    auto input = noise(250);
+    std::vector<sample_type> stuffed(input.size() * 4, sample_type{0.f});
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        stuffed[i * 4] = input[i];
+    }
+    std::vector<sample_type> expected(stuffed.size());
+    bit::dsp::fir<coefficient_type, sample_type, 32>{coefficients}.process(
+        std::span<const sample_type>{stuffed}, std::span{expected});
+
+    bit::dsp::fir_interpolator<coefficient_type, sample_type, 32, 4>
+        interpolator{coefficients};
+    std::vector<sample_type> interpolated(stuffed.size());
+    interpolator.process(std::span<const sample_type>{input},
+                         std::span{interpolated});
+
+    CHECK(interpolated == expected);
+}
+
+TEST_CASE("fir throughput against float reference", "[.benchmark][dsp|fir]")
+{
+    constexpr size_t taps = 64;
+    auto input            = noise(4096);
+    std::vector<sample_type> output(input.size());
+    auto fixed_coefficients =
+        bit::dsp::lowpass<coefficient_type, taps>(0.2);
+    bit::dsp::fir<coefficient_type, sample_type, taps> filter{
+        fixed_coefficients};
+
+    std::vector<float> float_input(input.size());
+    std::vector<float> float_output(input.size());
+    std::vector<float> float_coefficients(taps);
+    std::vector<float> float_history(2 * taps);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        float_input[i] = input[i].as<float>();
+    }
+    for (size_t k = 0; k < taps; ++k)
+    {
+        float_coefficients[k] = fixed_coefficients[k].as<float>();
+    }
+
+    BENCHMARK("fixed point fir, 64 taps x 4096 samples")
+    {
+        filter.process(std::span<const sample_type>{input}, std::span{output});
+        return output.back();
+    };
+
+    BENCHMARK("float fir, 64 taps x 4096 samples")
+    {
+        size_t position = 0;
+        for (size_t i = 0; i < float_input.size(); ++i)
+        {
+            position = position == 0 ? taps - 1 : position - 1;
+            float_history[position]        = float_input[i];
+            float_history[position + taps] = float_input[i];
+            float sum                      = 0;
+            for (size_t k = 0; k < taps; ++k)
+            {
+                sum += float_coefficients[k] * float_history[position + k];
+            }
+            float_output[i] = sum;
+        }
+        return float_output.back();
+    };
+}
@@ -0,0 +1,175 @@
+#include <dsp/mixer.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type = bit::qs<0, 15>;
+using mixer_type  = bit::dsp::mixer<sample_type>;
+
+std::vector<std::vector<sample_type>> voices(size_t count, size_t frames)
+{
+    std::vector<std::vector<sample_type>> result(count);
+    for (size_t v = 0; v < count; ++v)
+    {
+        result[v].resize(frames);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            auto angle = 2 * std::numbers::pi * static_cast<double>(v + 1) *
+                         static_cast<double>(i) / 64;
+            result[v][i] = sample_type{0.9 * std::sin(angle)};
+        }
+    }
+    return result;
+}
+
+std::vector<std::span<const sample_type>> spans(
+    const std::vector<std::vector<sample_type>>& blocks)
+{
+    return {blocks.begin(), blocks.end()};
+}
+} // namespace
+
+TEST_CASE("mixer pans with a constant power law", "[dsp|mixer]")
+{
+    std::vector<sample_type> voice(4, sample_type{0.5});
+    std::vector<std::span<const sample_type>> inputs{voice};
+    std::vector<sample_type> bus(8);
+    mixer_type mixer{1};
+
+    mixer.mix(inputs, bus);
+    CHECK(std::abs(bus[0].as<double>() - 0.5 / std::numbers::sqrt2) < 1e-4);
+    CHECK(bus[1].raw() == bus[0].raw());
+
+    mixer.set_voice(0, 1.0, -1.0);
+    mixer.mix(inputs, bus);
+    CHECK(bus[0].as<double>() == 0.5);
+    CHECK(bus[1].raw() == 0);
+
+    mixer.set_voice(0, 0.5, 1.0);
+    mixer.mix(inputs, bus);
+    CHECK(bus[0].raw() == 0);
+    CHECK(bus[1].as<double>() == 0.25);
+}
+
+TEST_CASE("mixer clamps channel gains of +6 dB and more", "[dsp|mixer]")
+{
+    using limits = std::numeric_limits<mixer_type::gain_type>;
+    std::vector<sample_type> voice(4, sample_type{0.25});
+    std::vector<std::span<const sample_type>> inputs{voice};
+    std::vector<sample_type> bus(8);
+    mixer_type mixer{1};
+
+    // just below the limit is kept
+    mixer.set_voice(0, 1.99, -1.0);
+    mixer.mix(inputs, bus);
+    CHECK(std::abs(bus[0].as<double>() - 0.4975) < 1e-4);
+
+    std::vector<sample_type> loudest(8);
+    mixer.set_voice(0, limits::max(), mixer_type::gain_type{});
+    mixer.mix(inputs, loudest);
+    mixer.set_voice(0, 2.0, -1.0);
+    mixer.mix(inputs, bus);
+    CHECK(bus == loudest);
+    CHECK(bus[1].raw() == 0);
+
+    mixer.set_voice(0, -4.0, 1.0);
+    mixer.mix(inputs, bus);
+    CHECK(bus[0].raw() == 0);
+    CHECK(bus[1].as<double>() == -0.5);
+}
+
+TEST_CASE("mixer saturates once, after the whole sum", "[dsp|mixer]")
+{
+    std::vector<sample_type> loud(4, sample_type{0.75});
+    std::vector<sample_type> inverted(4, sample_type{-0.75});
+    std::vector<std::span<const sample_type>> inputs{loud, loud, inverted};
+    std::vector<sample_type> bus(8);
+    mixer_type mixer{3};
+    for (size_t v = 0; v < 3; ++v)
+    {
+        mixer.set_voice(
+            v, mixer_type::gain_type{1.0}, mixer_type::gain_type{});
+    }
+
+    // clamping every add would give 1 - 0.75
+    mixer.mix(inputs, bus);
+    CHECK(bus[0].as<double>() == 0.75);
+
+    mixer.set_voice(2, mixer_type::gain_type{}, mixer_type::gain_type{});
+    mixer.mix(inputs, bus);
+    CHECK(bus[0] == std::numeric_limits<sample_type>::max());
+}
+
+TEST_CASE("mixer layouts give the same bus", "[dsp|mixer]")
+{
+    constexpr size_t frames = 1000;
+    auto blocks             = voices(16, frames);
+    auto inputs             = spans(blocks);
+
+    mixer_type mixer{16};
+    for (size_t v = 0; v < 16; ++v)
+    {
+        mixer.set_voice(v, 0.05, static_cast<double>(v) / 7.5 - 1);
+    }
+
+    std::vector<sample_type> interleaved(2 * frames);
+    mixer.mix(inputs, interleaved);
+
+    std::vector<sample_type> left(frames);
+    std::vector<sample_type> right(frames);
+    mixer.mix(inputs, left, right);
+
+    for (size_t i = 0; i < frames; ++i)
+    {
+        REQUIRE(interleaved[2 * i] == left[i]);
+        REQUIRE(interleaved[2 * i + 1] == right[i]);
+
+        // against a double reference, over a few chunks
+        double expected_left = 0, expected_right = 0;
+        for (size_t v = 0; v < 16; ++v)
+        {
+            auto angle  = static_cast<double>(v) / 7.5 * std::numbers::pi / 4;
+            auto sample = blocks[v][i].as<double>();
+            expected_left += 0.05 * std::cos(angle) * sample;
+            expected_right += 0.05 * std::sin(angle) * sample;
+        }
+        REQUIRE(std::abs(left[i].as<double>() - expected_left) < 1e-3);
+        REQUIRE(std::abs(right[i].as<double>() - expected_right) < 1e-3);
+    }
+}
+
+TEST_CASE("mixer throughput", "[.benchmark][dsp|mixer]")
+{
+    constexpr size_t frames = 256;
+    auto blocks             = voices(32, frames);
+    auto inputs             = spans(blocks);
+    std::vector<sample_type> bus(2 * frames);
+    mixer_type mixer{32};
+
+    BENCHMARK("saturate_add, 32 voices of 256 frames, mono")
+    {
+        for (size_t i = 0; i < frames; ++i)
+        {
+            sample_type sum{};
+            for (const auto& block : blocks)
+            {
+                sum = sum.saturate_add(block[i]);
+            }
+            bus[i] = sum;
+        }
+        return bus.front();
+    };
+
+    BENCHMARK("mixer, 32 voices of 256 frames, stereo")
+    {
+        mixer.mix(inputs, bus);
+        return bus.front();
+    };
+}
@@ -0,0 +1,213 @@
+#include <dsp/bitcrusher.h>
+#include <dsp/oversampled.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type = bit::qs<0, 15>;
+
+constexpr size_t size = 4096;
+// 93 is coprime with 4096, so no aliased harmonic lands on a harmonic bin
+constexpr size_t cycles = 93;
+
+// hard clipper at half scale, 12 dB of drive; the decimators would clip the
+// Gibbs overshoot of a full scale one
+struct clipper
+{
+    using sample_type = ::sample_type;
+
+    void process(std::span<sample_type> block) const noexcept
+    {
+        for (auto& sample : block)
+        {
+            auto raw = std::clamp(4 * sample.raw(), -16384, 16384);
+            sample   = bit::as_is_t{static_cast<int16_t>(raw)};
+        }
+    }
+};
+
+struct identity
+{
+    using sample_type = ::sample_type;
+
+    void process(std::span<sample_type>) const noexcept
+    {
+    }
+};
+
+std::vector<sample_type> sine(size_t cycles_per_block, double gain)
+{
+    std::vector<sample_type> result(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto angle = 2 * std::numbers::pi *
+                     static_cast<double>(cycles_per_block * i) /
+                     static_cast<double>(size);
+        result[i] = sample_type{gain * std::sin(angle)};
+    }
+    return result;
+}
+
+// the second pass over the periodic input, once the filters settled
+template <typename StageT>
+std::vector<double> steady(StageT& stage, std::span<const sample_type> input)
+{
+    std::vector<sample_type> block;
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+        block.assign(input.begin(), input.end());
+        for (size_t i = 0; i < size; i += 256)
+        {
+            stage.process(std::span{block}.subspan(i, 256));
+        }
+    }
+    std::vector<double> result(size);
+    std::ranges::transform(block, result.begin(), [](sample_type sample) {
+        return sample.as<double>();
+    });
+    return result;
+}
+
+double energy(std::span<const double> samples, size_t bin)
+{
+    double re = 0, im = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto angle = 2 * std::numbers::pi * static_cast<double>(bin * i) /
+                     static_cast<double>(size);
+        re += samples[i] * std::cos(angle);
+        im -= samples[i] * std::sin(angle);
+    }
+    return re * re + im * im;
+}
+
+// energy of the non harmonic bins below 20 kHz at 48 kHz relative to the
+// harmonic ones, in dB; aliases folded into the top, filter transition band
+// stay out of it
+double aliasing(std::span<const double> samples)
+{
+    constexpr size_t audible = size * 20 / 48;
+    double harmonics         = 0;
+    double aliases           = 0;
+    for (size_t bin = 1; bin < audible; ++bin)
+    {
+        (bin % cycles == 0 ? harmonics : aliases) += energy(samples, bin);
+    }
+    return 10 * std::log10(aliases / harmonics);
+}
+} // namespace
+
+TEST_CASE("halfband coefficients sum to the requested gain",
+          "[dsp|oversampled]")
+{
+    constexpr auto taps = bit::dsp::halfband<bit::qs<0, 15>, 16>();
+    double sum          = 0;
+    for (auto tap : taps)
+    {
+        sum += 2 * tap.as<double>();
+    }
+    CHECK(std::abs(sum + 0.5 - 1.0) < 1e-3);
+    // sinc sign pattern at odd distances from the center
+    CHECK(taps[0].as<double>() > 0);
+    CHECK(taps[1].as<double>() < 0);
+    CHECK(taps[2].as<double>() > 0);
+}
+
+TEST_CASE("oversampling passes the signal through with its latency",
+          "[dsp|oversampled]")
+{
+    auto input = sine(cycles, 0.5);
+
+    auto check = [&](auto oversampler) {
+        auto output = steady(oversampler, input);
+        auto delay  = oversampler.latency();
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto t = static_cast<double>(i) - delay;
+            auto expected =
+                0.5 * std::sin(2 * std::numbers::pi *
+                               static_cast<double>(cycles) * t / size);
+            INFO("Factor: " << oversampler.factor << " sample: " << i);
+            REQUIRE(std::abs(output[i] - expected) < 2e-3);
+        }
+    };
+    check(bit::dsp::oversampled<2, identity>{256});
+    check(bit::dsp::oversampled<4, identity>{256});
+    check(bit::dsp::oversampled<8, identity>{256});
+}
+
+TEST_CASE("oversampling reduces aliasing of a clipper", "[dsp|oversampled]")
+{
+    auto input = sine(cycles, 0.8);
+
+    clipper plain;
+    bit::dsp::oversampled<2, clipper> twice{256};
+    bit::dsp::oversampled<4, clipper> four_times{256};
+    bit::dsp::oversampled<8, clipper> eight_times{256};
+
+    auto base = aliasing(steady(plain, input));
+    auto x2   = aliasing(steady(twice, input));
+    auto x4   = aliasing(steady(four_times, input));
+    auto x8   = aliasing(steady(eight_times, input));
+    INFO("1x: " << base << " dB, 2x: " << x2 << " dB, 4x: " << x4
+                << " dB, 8x: " << x8 << " dB");
+    CHECK(x2 < base - 10);
+    CHECK(x4 < x2 - 10);
+    CHECK(x8 < x4 - 10);
+}
+
+TEST_CASE("oversampled processes blocks longer than its buffers",
+          "[dsp|oversampled]")
+{
+    auto input = sine(cycles, 0.8);
+    bit::dsp::oversampled<4, bit::dsp::bitcrusher<sample_type>> chunked{
+        100, bit::dsp::bitcrusher<sample_type>{6}};
+    bit::dsp::oversampled<4, bit::dsp::bitcrusher<sample_type>> whole{
+        size, bit::dsp::bitcrusher<sample_type>{6}};
+
+    std::vector<sample_type> a{input};
+    std::vector<sample_type> b{input};
+    chunked.process(a);
+    whole.process(b);
+    CHECK(a == b);
+}
+
+TEST_CASE("oversampling cost per factor", "[.benchmark][dsp|oversampled]")
+{
+    auto input = sine(cycles, 0.8);
+    std::vector<sample_type> block(256);
+    clipper plain;
+    bit::dsp::oversampled<2, clipper> twice{256};
+    bit::dsp::oversampled<4, clipper> four_times{256};
+    bit::dsp::oversampled<8, clipper> eight_times{256};
+
+    auto run = [&](auto& stage) {
+        std::copy_n(input.begin(), block.size(), block.begin());
+        stage.process(block);
+        return block.back();
+    };
+
+    BENCHMARK("clipper, 256 samples")
+    {
+        return run(plain);
+    };
+    BENCHMARK("clipper at 2x, 256 samples")
+    {
+        return run(twice);
+    };
+    BENCHMARK("clipper at 4x, 256 samples")
+    {
+        return run(four_times);
+    };
+    BENCHMARK("clipper at 8x, 256 samples")
+    {
+        return run(eight_times);
+    };
+}
@@ -0,0 +1,170 @@
+#include <dsp/polyblep.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type = bit::qs<0, 15>;
+
+constexpr size_t size = 4096;
+// 93 is coprime with 4096, so no aliased harmonic lands on a harmonic bin
+constexpr size_t cycles = 93;
+
+constexpr bit::dsp::phase_type increment{
+    static_cast<double>(cycles) / static_cast<double>(size)};
+
+template <typename OscillatorT>
+std::vector<double> render(OscillatorT oscillator)
+{
+    std::vector<sample_type> block(size);
+    oscillator.render(block);
+    std::vector<double> samples(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        samples[i] = block[i].template as<double>();
+    }
+    return samples;
+}
+
+// energy outside of the harmonic bins relative to the energy inside, in dB
+double aliasing(std::span<const double> samples)
+{
+    double total = 0;
+    for (auto sample : samples)
+    {
+        total += sample * sample;
+    }
+    // Parseval: total energy is the sum of |X[k]|^2 / N over all bins
+    double harmonics = 0;
+    for (size_t bin = 0; bin <= size / 2; bin += cycles)
+    {
+        double re = 0, im = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto angle = 2 * std::numbers::pi * static_cast<double>(bin * i) /
+                         static_cast<double>(size);
+            re += samples[i] * std::cos(angle);
+            im -= samples[i] * std::sin(angle);
+        }
+        auto energy = (re * re + im * im) / static_cast<double>(size);
+        harmonics += bin == 0 ? energy : 2 * energy;
+    }
+    return 10 * std::log10((total - harmonics) / harmonics);
+}
+
+template <typename NaiveT>
+std::vector<double> naive(NaiveT waveform)
+{
+    std::vector<double> samples(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto phase =
+            std::fmod(static_cast<double>(i * cycles) / size, 1.0);
+        samples[i] = waveform(phase);
+    }
+    return samples;
+}
+} // namespace
+
+TEST_CASE("polyblep saw aliases less than naive saw", "[dsp|polyblep]")
+{
+    auto reference = aliasing(naive([](double t) { return 2 * t - 1; }));
+    auto corrected =
+        aliasing(render(bit::dsp::polyblep_saw<sample_type>{increment}));
+    INFO("naive: " << reference << " dB, polyblep: " << corrected << " dB");
+    CHECK(corrected < reference - 15);
+}
+
+TEST_CASE("polyblep pulse aliases less than naive pulse", "[dsp|polyblep]")
+{
+    auto reference = aliasing(
+        naive([](double t) { return t < 0.25 ? 1.0 : -1.0; }));
+    bit::dsp::polyblep_pulse<sample_type> pulse{increment};
+    pulse.set_width(bit::dsp::phase_type{0.25});
+    auto samples   = render(pulse);
+    auto corrected = aliasing(samples);
+    INFO("naive: " << reference << " dB, polyblep: " << corrected << " dB");
+    CHECK(corrected < reference - 15);
+
+    double mean = 0;
+    for (auto sample : samples)
+    {
+        mean += sample / size;
+    }
+    CHECK(std::abs(mean + 0.5) < 1e-2);
+}
+
+TEST_CASE("polyblamp triangle aliases less than naive triangle",
+          "[dsp|polyblep]")
+{
+    auto reference =
+        aliasing(naive([](double t) { return 4 * std::abs(t - 0.5) - 1; }));
+    auto corrected =
+        aliasing(render(bit::dsp::polyblep_triangle<sample_type>{increment}));
+    INFO("naive: " << reference << " dB, polyblamp: " << corrected << " dB");
+    CHECK(corrected < reference - 10);
+}
+
+TEST_CASE("polyblep oscillator continues phase across blocks",
+          "[dsp|polyblep]")
+{
+    bit::dsp::polyblep_saw<bit::qs<0, 31>> whole{increment};
+    auto split = whole;
+    std::vector<bit::qs<0, 31>> expected(1000);
+    std::vector<bit::qs<0, 31>> actual(1000);
+
+    whole.render(expected);
+    split.render(std::span{actual}.first(123));
+    split.render(std::span{actual}.subspan(123, 500));
+    for (size_t i = 623; i < actual.size(); ++i)
+    {
+        actual[i] = split.next();
+    }
+
+    CHECK(actual == expected);
+    CHECK(split.phase() == whole.phase());
+}
+
+TEST_CASE("polyblep oscillator throughput", "[.benchmark][dsp|polyblep]")
+{
+    std::vector<sample_type> block(size);
+    bit::dsp::polyblep_saw<sample_type> saw{increment};
+    bit::dsp::polyblep_pulse<sample_type> pulse{increment};
+    bit::dsp::polyblep_triangle<sample_type> triangle{increment};
+    pulse.set_width(bit::dsp::phase_type{0.3});
+
+    BENCHMARK("saw, 4096 samples")
+    {
+        saw.render(block);
+        return block.back();
+    };
+
+    BENCHMARK("pulse, 4096 samples")
+    {
+        pulse.render(block);
+        return block.back();
+    };
+
+    BENCHMARK("triangle, 4096 samples")
+    {
+        triangle.render(block);
+        return block.back();
+    };
+
+    BENCHMARK("naive saw, 4096 samples")
+    {
+        auto phase = saw.phase().raw();
+        auto step  = saw.increment().raw();
+        for (auto& sample : block)
+        {
+            sample = bit::as_is_t{static_cast<int16_t>((phase >> 16) - 32768)};
+            phase += step;
+        }
+        return block.back();
+    };
+}
@@ -0,0 +1,209 @@
+#include <dsp/requantize.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+using wide_type   = bit::qs<0, 31>;
+using narrow_type = bit::qs<0, 7>;
+
+constexpr size_t size = 4096;
+// coprime with 4096, so harmonics land on their own bins
+constexpr size_t cycles = 31;
+
+// low level sine, amplitude in output lsb
+std::vector<wide_type> sine(double amplitude)
+{
+    std::vector<wide_type> result(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto angle = 2 * std::numbers::pi * static_cast<double>(cycles * i) /
+                     static_cast<double>(size);
+        result[i] = wide_type{amplitude / 128 * std::sin(angle)};
+    }
+    return result;
+}
+
+std::vector<narrow_type> requantize(
+    std::span<const wide_type> input,
+    bit::dsp::noise_shaping shaping = bit::dsp::noise_shaping::none,
+    bool dither                     = true,
+    uint64_t seed                   = 1)
+{
+    bit::dsp::requantizer<wide_type, narrow_type> requantizer{
+        seed, shaping, dither};
+    std::vector<narrow_type> output(input.size());
+    requantizer.process(input, output);
+    return output;
+}
+
+// quantization error in output lsb
+std::vector<double> error(std::span<const wide_type> input,
+                          std::span<const narrow_type> output)
+{
+    std::vector<double> result(input.size());
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        result[i] = (output[i].as<double>() - input[i].as<double>()) * 128;
+    }
+    return result;
+}
+
+double magnitude(std::span<const double> samples, size_t bin)
+{
+    double re = 0, im = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        auto angle = 2 * std::numbers::pi * static_cast<double>(bin * i) /
+                     static_cast<double>(samples.size());
+        re += samples[i] * std::cos(angle);
+        im -= samples[i] * std::sin(angle);
+    }
+    return std::sqrt(re * re + im * im);
+}
+
+// error power in the bins below fs / 32
+double low_band_power(std::span<const double> samples)
+{
+    double power = 0;
+    for (size_t bin = 1; bin < size / 32; ++bin)
+    {
+        auto m = magnitude(samples, bin);
+        power += m * m;
+    }
+    return power;
+}
+} // namespace
+
+TEST_CASE("requantizer without dither rounds to nearest", "[dsp|requantize]")
+{
+    std::vector<wide_type> input;
+    for (double value : {0.0, 0.3, 0.5, 0.7, -0.3, -0.5, -0.7, 1.5, -1.5})
+    {
+        input.push_back(wide_type{value / 128});
+    }
+    input.push_back(std::numeric_limits<wide_type>::max());
+    input.push_back(std::numeric_limits<wide_type>::lowest());
+
+    auto output = requantize(input, bit::dsp::noise_shaping::none, false);
+    std::vector<int> raw(output.size());
+    std::ranges::transform(
+        output, raw.begin(), [](narrow_type sample) { return sample.raw(); });
+    // half rounds up, full scale saturates instead of wrapping
+    CHECK(raw == std::vector<int>{0, 0, 1, 1, 0, 0, -1, 2, -1, 127, -128});
+}
+
+TEST_CASE("requantizer is reproducible from its seed", "[dsp|requantize]")
+{
+    auto input = sine(3.3);
+
+    for (auto shaping : {bit::dsp::noise_shaping::none,
+                         bit::dsp::noise_shaping::first_order,
+                         bit::dsp::noise_shaping::second_order})
+    {
+        auto expected = requantize(input, shaping);
+        CHECK(requantize(input, shaping, true, 2) != expected);
+
+        for (size_t block_size : {1, 7, 64, 100})
+        {
+            bit::dsp::requantizer<wide_type, narrow_type> requantizer{1,
+                                                                      shaping};
+            std::vector<narrow_type> output(size);
+            for (size_t i = 0; i < size; i += block_size)
+            {
+                auto count = std::min(block_size, size - i);
+                requantizer.process(std::span{input}.subspan(i, count),
+                                    std::span{output}.subspan(i, count));
+            }
+            INFO("Block size: " << block_size);
+            REQUIRE(output == expected);
+        }
+    }
+}
+
+TEST_CASE("dither decorrelates the requantization error", "[dsp|requantize]")
+{
+    auto input = sine(1.5);
+
+    auto truncated = error(input, requantize(input, {}, false));
+    auto dithered  = error(input, requantize(input));
+
+    // plain rounding of a 1.5 lsb sine is a staircase, rich in odd harmonics
+    for (size_t harmonic : {3, 7})
+    {
+        INFO("Harmonic: " << harmonic);
+        CHECK(magnitude(dithered, harmonic * cycles) <
+              magnitude(truncated, harmonic * cycles) / 4);
+    }
+
+    // TPDF: mean 0, variance 1 / 12 + 1 / 6 lsb^2
+    double mean = 0, power = 0;
+    for (auto sample : dithered)
+    {
+        mean += sample;
+        power += sample * sample;
+    }
+    mean /= size;
+    power /= size;
+    CHECK(std::abs(mean) < 0.05);
+    CHECK(std::abs(power - 0.25) < 0.03);
+}
+
+TEST_CASE("noise shaping moves the error out of the low band",
+          "[dsp|requantize]")
+{
+    auto input = sine(20);
+
+    auto flat   = error(input, requantize(input));
+    auto first  = error(input,
+                       requantize(input, bit::dsp::noise_shaping::first_order));
+    auto second = error(
+        input, requantize(input, bit::dsp::noise_shaping::second_order));
+
+    CHECK(low_band_power(first) < low_band_power(flat) / 10);
+    CHECK(low_band_power(second) < low_band_power(first) / 10);
+}
+
+TEST_CASE("requantizer throughput", "[.benchmark][dsp|requantize]")
+{
+    auto input = sine(100);
+    std::vector<bit::qs<0, 15>> output(size);
+
+    BENCHMARK("narrow_as")
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            output[i] = input[i].narrow_as<bit::qs<0, 15>>();
+        }
+        return output.back();
+    };
+
+    for (auto [name, shaping, dither] :
+         {std::tuple{"rounding", bit::dsp::noise_shaping::none, false},
+          std::tuple{"tpdf", bit::dsp::noise_shaping::none, true},
+          std::tuple{"tpdf, first order",
+                     bit::dsp::noise_shaping::first_order,
+                     true},
+          std::tuple{"tpdf, second order",
+                     bit::dsp::noise_shaping::second_order,
+                     true}})
+    {
+        bit::dsp::requantizer<wide_type, bit::qs<0, 15>> requantizer{
+            1, shaping, dither};
+        BENCHMARK(std::string{name} + ", 4096 samples")
+        {
+            requantizer.process(input, output);
+            return output.back();
+        };
+    }
+}
@@ -0,0 +1,283 @@
+#include <dsp/resampler.h>
+#include <wave/reader.hpp>
+#include <wave/writer.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <numbers>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using sample_type = bit::qs<0, 15>;
+
+template <typename T>
+std::vector<T> sine(double frequency, double rate, size_t size, double gain)
+{
+    std::vector<T> result(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto value = gain * std::sin(2 * std::numbers::pi * frequency *
+                                     static_cast<double>(i) / rate);
+        result[i]  = T(value);
+    }
+    return result;
+}
+
+template <typename T> double as_double(T sample)
+{
+    if constexpr (std::floating_point<T>)
+    {
+        return sample;
+    }
+    else
+    {
+        return sample.template as<double>();
+    }
+}
+
+template <typename T> double rms(std::span<const T> block)
+{
+    double sum = 0;
+    for (auto sample : block)
+    {
+        sum += as_double(sample) * as_double(sample);
+    }
+    return std::sqrt(sum / static_cast<double>(block.size()));
+}
+
+// compares with the continuous sine shifted by the resampler latency
+template <typename T>
+double max_error(const bit::dsp::resampler<T>& resampler,
+                 std::span<const T> output,
+                 double frequency,
+                 double input_rate,
+                 double gain,
+                 size_t skip)
+{
+    auto step   = static_cast<double>(resampler.down()) /
+                static_cast<double>(resampler.up());
+    double peak = 0;
+    for (size_t i = skip; i < output.size(); ++i)
+    {
+        auto t = static_cast<double>(i) * step - resampler.latency();
+        auto expected =
+            gain * std::sin(2 * std::numbers::pi * frequency * t / input_rate);
+        peak = std::max(peak, std::abs(as_double(output[i]) - expected));
+    }
+    return peak;
+}
+} // namespace
+
+TEST_CASE("resampler reduces the ratio", "[dsp|resampler]")
+{
+    bit::dsp::resampler<sample_type> cd_to_dat{44100, 48000};
+    CHECK(cd_to_dat.up() == 160);
+    CHECK(cd_to_dat.down() == 147);
+
+    bit::dsp::resampler<float> halving{96000, 48000};
+    CHECK(halving.up() == 1);
+    CHECK(halving.down() == 2);
+
+    CHECK_THROWS(bit::dsp::resampler<float>{0, 48000});
+}
+
+TEST_CASE("resampler interpolates a sine", "[dsp|resampler]")
+{
+    constexpr double input_rate = 44100;
+    constexpr double frequency  = 1000;
+    constexpr double gain       = 0.5;
+
+    SECTION("qnumber")
+    {
+        bit::dsp::resampler<sample_type> resampler{
+            44100, 48000, bit::dsp::resampler_quality::high};
+        auto input = sine<sample_type>(frequency, input_rate, 4410, gain);
+        std::vector<sample_type> output(resampler.max_output(input.size()));
+        auto [consumed, produced] = resampler.process(input, output);
+        CHECK(consumed == input.size());
+        CHECK(produced == output.size());
+        CHECK(max_error<sample_type>(
+                  resampler, output, frequency, input_rate, gain, 64) < 1e-3);
+    }
+
+    SECTION("wide qnumber")
+    {
+        using wide_type = bit::qs<0, 31>;
+        bit::dsp::resampler<wide_type> resampler{
+            44100, 48000, bit::dsp::resampler_quality::high};
+        auto input = sine<wide_type>(frequency, input_rate, 4410, gain);
+        std::vector<wide_type> output(resampler.max_output(input.size()));
+        resampler.process(input, output);
+        CHECK(max_error<wide_type>(
+                  resampler, output, frequency, input_rate, gain, 64) < 1e-4);
+    }
+
+    SECTION("float")
+    {
+        bit::dsp::resampler<float> resampler{
+            44100, 48000, bit::dsp::resampler_quality::high};
+        auto input = sine<float>(frequency, input_rate, 4410, gain);
+        std::vector<float> output(resampler.max_output(input.size()));
+        auto [consumed, produced] = resampler.process(input, output);
+        CHECK(consumed == input.size());
+        CHECK(produced == output.size());
+        CHECK(max_error<float>(
+                  resampler, output, frequency, input_rate, gain, 64) < 1e-4);
+    }
+}
+
+TEST_CASE("resampler output doesn't depend on the block sizes",
+          "[dsp|resampler]")
+{
+    auto input = sine<sample_type>(440, 48000, 3000, 0.9);
+
+    bit::dsp::resampler<sample_type> whole{48000, 44100};
+    std::vector<sample_type> expected(whole.max_output(input.size()));
+    auto [consumed, produced] = whole.process(input, expected);
+    REQUIRE(produced == expected.size());
+
+    for (size_t block_size : {1, 7, 64, 512})
+    {
+        bit::dsp::resampler<sample_type> streamed{48000, 44100};
+        std::vector<sample_type> output;
+        std::vector<sample_type> block(block_size);
+        auto rest = std::span<const sample_type>{input};
+        while (not rest.empty())
+        {
+            // output blocks of the same size, so that both sides run out
+            auto result = streamed.process(rest, block);
+            output.insert(output.end(),
+                          block.begin(),
+                          block.begin() + static_cast<ptrdiff_t>(
+                                              result.produced));
+            rest = rest.subspan(result.consumed);
+        }
+        INFO("Block size: " << block_size);
+        REQUIRE(output.size() == expected.size());
+        for (size_t i = 0; i < output.size(); ++i)
+        {
+            REQUIRE(output[i].raw() == expected[i].raw());
+        }
+    }
+}
+
+TEST_CASE("decimating resampler stops aliases", "[dsp|resampler]")
+{
+    // 30 kHz would fold down to 18 kHz
+    auto input = sine<float>(30000, 96000, 9600, 0.5);
+    auto pass  = sine<float>(10000, 96000, 9600, 0.5);
+
+    for (auto quality : {bit::dsp::resampler_quality::medium,
+                         bit::dsp::resampler_quality::high})
+    {
+        bit::dsp::resampler<float> stopping{96000, 48000, quality};
+        bit::dsp::resampler<float> passing{96000, 48000, quality};
+        std::vector<float> stopped(stopping.max_output(input.size()));
+        std::vector<float> passed(passing.max_output(pass.size()));
+        stopping.process(input, stopped);
+        passing.process(pass, passed);
+
+        auto skip       = size_t{64};
+        auto stopped_db = 20 * std::log10(rms<float>(std::span{stopped}
+                                                         .subspan(skip)) /
+                                          rms<float>(input));
+        auto passed_db =
+            20 * std::log10(rms<float>(std::span{passed}.subspan(skip)) /
+                            rms<float>(pass));
+        CHECK(stopped_db < -60);
+        CHECK(std::abs(passed_db) < 0.1);
+    }
+}
+
+TEST_CASE("resampler converts a wave file", "[dsp|resampler]")
+{
+    auto directory = std::filesystem::temp_directory_path();
+    auto source    = directory / "bitcrackle_resampler_44100.wav";
+    auto target    = directory / "bitcrackle_resampler_48000.wav";
+
+    constexpr size_t frames = 44100 / 10;
+    {
+        bit::wave::writer writer{bit::wave::header{1, 44100, 16}, source};
+        auto samples = sine<double>(1000, 44100, frames, 0.5);
+        std::vector<int16_t> pcm(frames);
+        std::ranges::transform(samples, pcm.begin(), [](double sample) {
+            return static_cast<int16_t>(std::lround(sample * 32767));
+        });
+        writer.write(std::span{pcm});
+    }
+
+    bit::wave::reader reader{source};
+    REQUIRE(reader.header().sample_rate == 44100);
+    bit::dsp::resampler<sample_type> resampler{reader.header().sample_rate,
+                                               48000};
+    size_t written = 0;
+    {
+        bit::wave::writer writer{bit::wave::header{1, 48000, 16}, target};
+        std::vector<int16_t> pcm(256);
+        std::vector<sample_type> input(256);
+        std::vector<sample_type> output(resampler.max_output(input.size()));
+        std::vector<int16_t> converted(output.size());
+        for (auto read = reader.read(std::span{pcm}); not read.empty();
+             read      = reader.read(std::span{pcm}))
+        {
+            std::ranges::transform(read, input.begin(), [](int16_t sample) {
+                return sample_type{bit::as_is_t{sample}};
+            });
+            auto [consumed, produced] = resampler.process(
+                std::span{input}.first(read.size()), output);
+            REQUIRE(consumed == read.size());
+            std::ranges::transform(std::span{output}.first(produced),
+                                   converted.begin(),
+                                   [](sample_type sample) {
+                                       return sample.raw();
+                                   });
+            written += writer.write(std::span{converted}.first(produced));
+        }
+    }
+
+    bit::wave::reader result{target};
+    CHECK(result.header().sample_rate == 48000);
+    CHECK(result.frames_left() == written);
+    CHECK(written >= frames * 48000 / 44100 - 1);
+    CHECK(written <= frames * 48000 / 44100 + 1);
+
+    std::filesystem::remove(source);
+    std::filesystem::remove(target);
+}
+
+TEST_CASE("resampler throughput", "[.benchmark][dsp|resampler]")
+{
+    // one second of one channel, real time factor is 1 s / measured time
+    auto qinput = sine<sample_type>(1000, 44100, 44100, 0.5);
+    auto finput = sine<float>(1000, 44100, 44100, 0.5);
+    std::vector<sample_type> qoutput(48001);
+    std::vector<float> foutput(48001);
+
+    for (auto [name, quality] :
+         {std::pair{"low", bit::dsp::resampler_quality::low},
+          std::pair{"medium", bit::dsp::resampler_quality::medium},
+          std::pair{"high", bit::dsp::resampler_quality::high}})
+    {
+        bit::dsp::resampler<sample_type> qresampler{44100, 48000, quality};
+        BENCHMARK(std::string{"qs<0, 15> 1 s 44.1 -> 48 kHz, "} + name)
+        {
+            qresampler.reset();
+            return qresampler.process(qinput, qoutput).produced;
+        };
+
+        bit::dsp::resampler<float> fresampler{44100, 48000, quality};
+        BENCHMARK(std::string{"float 1 s 44.1 -> 48 kHz, "} + name)
+        {
+            fresampler.reset();
+            return fresampler.process(finput, foutput).produced;
+        };
+    }
+}
@@ -0,0 +1,194 @@
+#include <dsp/smoothed.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace
+{
+using gain_type   = bit::qu<1, 31>;
+using sample_type = bit::qs<0, 23>;
+
+// the value at every sample, rendered in blocks of block_size
+std::vector<double> render(bit::dsp::smoothed<gain_type>& parameter,
+                           size_t block_size,
+                           size_t size)
+{
+    std::vector<gain_type> values(size);
+    for (size_t i = 0; i < size; i += block_size)
+    {
+        parameter.render(
+            std::span{values}.subspan(i, std::min(block_size, size - i)));
+    }
+    std::vector<double> result(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        result[i] = values[i].as<double>();
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("linear ramps reach the target in their length", "[dsp|smoothed]")
+{
+    bit::dsp::smoothed<gain_type> gain{gain_type{0.0}, 100};
+    REQUIRE(not gain.is_smoothing());
+
+    gain.set_target(gain_type{1.0});
+    REQUIRE(gain.is_smoothing());
+    auto values = render(gain, 48, 200);
+
+    CHECK(values[0] == 0);
+    CHECK(std::abs(values[25] - 0.25) < 1e-6);
+    CHECK(std::abs(values[50] - 0.5) < 1e-6);
+    CHECK(values[99] < 1.0);
+    CHECK(values[100] == 1.0);
+    CHECK(values[199] == 1.0);
+    CHECK(std::ranges::is_sorted(values));
+    REQUIRE(not gain.is_smoothing());
+    REQUIRE(gain.current() == gain_type{1.0});
+}
+
+TEST_CASE("exponential ramps start fast and settle on the target",
+          "[dsp|smoothed]")
+{
+    bit::dsp::smoothed<gain_type> gain{
+        gain_type{1.0}, 200, bit::dsp::ramp_shape::exponential};
+    gain.set_target(gain_type{0.0});
+    auto values = render(gain, 64, 300);
+
+    CHECK(values[0] == 1.0);
+    // halfway down in a ninth of the time, -60 dB at the end
+    CHECK(values[22] < 0.5);
+    CHECK(values[199] < 0.002);
+    CHECK(values[200] == 0);
+    CHECK(std::ranges::is_sorted(values, std::greater{}));
+    REQUIRE(not gain.is_smoothing());
+}
+
+TEST_CASE("block size doesn't change the ramp", "[dsp|smoothed]")
+{
+    for (auto shape :
+         {bit::dsp::ramp_shape::linear, bit::dsp::ramp_shape::exponential})
+    {
+        bit::dsp::smoothed<gain_type> whole{gain_type{0.2}, 150, shape};
+        bit::dsp::smoothed<gain_type> split{gain_type{0.2}, 150, shape};
+        whole.set_target(gain_type{0.9});
+        split.set_target(gain_type{0.9});
+        REQUIRE(render(whole, 256, 256) == render(split, 7, 256));
+    }
+}
+
+TEST_CASE("a new target glides on from the current value", "[dsp|smoothed]")
+{
+    bit::dsp::smoothed<gain_type> gain{gain_type{0.0}, 100};
+    gain.set_target(gain_type{1.0});
+    auto first = render(gain, 64, 50);
+    gain.set_target(gain_type{0.0});
+    auto second = render(gain, 64, 100);
+
+    CHECK(std::abs(second[0] - 0.5) < 1e-6);
+    CHECK(std::abs(second[50] - 0.25) < 1e-6);
+    CHECK(second[99] > 0);
+    REQUIRE(gain.current() == gain_type{0.0});
+
+    gain.jump(gain_type{0.75});
+    REQUIRE(not gain.is_smoothing());
+    REQUIRE(render(gain, 64, 4)[0] == 0.75);
+}
+
+TEST_CASE("advance moves the ramp without rendering it", "[dsp|smoothed]")
+{
+    for (auto shape :
+         {bit::dsp::ramp_shape::linear, bit::dsp::ramp_shape::exponential})
+    {
+        bit::dsp::smoothed<bit::qu<15, 17>> cutoff{
+            bit::qu<15, 17>{1000.0}, 480, shape};
+        bit::dsp::smoothed<bit::qu<15, 17>> rendered{
+            bit::qu<15, 17>{1000.0}, 480, shape};
+        cutoff.set_target(bit::qu<15, 17>{8000.0});
+        rendered.set_target(bit::qu<15, 17>{8000.0});
+
+        std::vector<bit::qu<15, 17>> block(64);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            cutoff.advance(block.size());
+            rendered.render(block);
+            REQUIRE(cutoff.current() == rendered.current());
+        }
+        cutoff.advance(1000);
+        REQUIRE(not cutoff.is_smoothing());
+        REQUIRE(cutoff.current() == bit::qu<15, 17>{8000.0});
+    }
+}
+
+TEST_CASE("apply multiplies every channel by the ramp", "[dsp|smoothed]")
+{
+    bit::dsp::smoothed<gain_type> gain{gain_type{1.0}, 64};
+    std::vector<sample_type> left(128, sample_type{0.5});
+    std::vector<sample_type> right(128, sample_type{-0.5});
+
+    // unity leaves the samples alone
+    gain.apply(std::span{left}, std::span{right});
+    REQUIRE(left[0] == sample_type{0.5});
+
+    gain.set_target(gain_type{0.5});
+    gain.apply(std::span{left}, std::span{right});
+    CHECK(left[0] == sample_type{0.5});
+    CHECK(std::abs(left[32].as<double>() - 0.375) < 1e-6);
+    CHECK(std::abs(right[32].as<double>() + 0.375) < 1e-6);
+    CHECK(left[64] == sample_type{0.25});
+    CHECK(right[127] == sample_type{-0.25});
+
+    // saturates instead of wrapping
+    gain.jump(gain_type{1.9});
+    std::vector<sample_type> loud(4, sample_type{0.75});
+    gain.apply(std::span{loud});
+    REQUIRE(loud[0] == std::numeric_limits<sample_type>::max());
+}
+
+TEST_CASE("smoothed parameter", "[.benchmark][dsp|smoothed]")
+{
+    std::vector<sample_type> left(256, sample_type{0.5});
+    std::vector<sample_type> right(256, sample_type{0.5});
+    bit::dsp::smoothed<gain_type> gain{gain_type{0.5}, 4800};
+    BENCHMARK("ramping gain, 256 stereo samples")
+    {
+        if (not gain.is_smoothing())
+        {
+            gain.jump(gain_type{0.5});
+            gain.set_target(gain_type{0.6});
+        }
+        gain.apply(std::span{left}, std::span{right});
+        return left[0];
+    };
+    gain.jump(gain_type{1.0});
+    BENCHMARK("settled at unity, 256 stereo samples")
+    {
+        gain.apply(std::span{left}, std::span{right});
+        return left[0];
+    };
+
+    // per sample one-pole smoothing in floating point, for comparison; into
+    // other buffers, in place the samples would decay into denormals
+    std::vector<float> input(256, 0.5f);
+    std::vector<float> left_float(256);
+    std::vector<float> right_float(256);
+    float current = 0.5f;
+    float target  = 0.6f;
+    BENCHMARK("scalar one-pole gain, 256 stereo samples")
+    {
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            current += 0.001f * (target - current);
+            left_float[i]  = input[i] * current;
+            right_float[i] = input[i] * current;
+        }
+        return left_float[0];
+    };
+}
@@ -0,0 +1,135 @@
+#include <dsp/wavetable.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type = bit::qs<0, 15>;
+using table_type  = bit::dsp::wavetable<sample_type, 2048>;
+
+std::vector<double> saw_harmonics()
+{
+    std::vector<double> amplitudes(table_type::max_harmonic(0));
+    for (size_t h = 1; h <= amplitudes.size(); ++h)
+    {
+        amplitudes[h - 1] = (h % 2 ? 2 : -2) / (std::numbers::pi * h);
+    }
+    return amplitudes;
+}
+
+const table_type& saw_table()
+{
+    static const auto table = table_type::from_harmonics(saw_harmonics());
+    return table;
+}
+} // namespace
+
+TEST_CASE("wavetable levels drop one octave of harmonics each",
+          "[dsp|wavetable]")
+{
+    STATIC_REQUIRE(table_type::levels == 10);
+    STATIC_REQUIRE(table_type::max_harmonic(0) == 512);
+    STATIC_REQUIRE(table_type::max_harmonic(9) == 1);
+
+    // the last level is a plain sine, as loud as the fundamental of level 0
+    auto sine = saw_table().level(9);
+    auto peak = sine[table_type::size / 4].as<double>();
+    for (size_t i = 0; i < table_type::size; ++i)
+    {
+        auto expected = peak * std::sin(2 * std::numbers::pi *
+                                        static_cast<double>(i) /
+                                        table_type::size);
+        REQUIRE(std::abs(sine[i].as<double>() - expected) < 1e-3);
+    }
+    CHECK(sine.back() == sine.front());
+}
+
+TEST_CASE("wavetable level follows pitch without aliasing", "[dsp|wavetable]")
+{
+    for (double frequency = 20; frequency < 24000; frequency *= 1.05)
+    {
+        auto increment = bit::dsp::phase_increment(frequency, 48000);
+        auto level     = table_type::level_for(increment);
+        INFO("Frequency: " << frequency << " level: " << level);
+        REQUIRE(frequency * table_type::max_harmonic(level) < 24000);
+        if (level > 0)
+        {
+            REQUIRE(frequency * table_type::max_harmonic(level - 1) >= 24000);
+        }
+    }
+}
+
+TEST_CASE("wavetable from cycle matches from harmonics", "[dsp|wavetable]")
+{
+    std::vector<double> cycle(3000);
+    for (size_t i = 0; i < cycle.size(); ++i)
+    {
+        auto t   = static_cast<double>(i) / static_cast<double>(cycle.size());
+        cycle[i] = std::sin(2 * std::numbers::pi * t) +
+                   0.5 * std::cos(2 * std::numbers::pi * 3 * t);
+    }
+    auto from_cycle = table_type::from_cycle(cycle);
+    auto level      = from_cycle.level(0);
+    double peak     = 0;
+    for (size_t i = 0; i < table_type::size; ++i)
+    {
+        auto t = static_cast<double>(i) / table_type::size;
+        peak   = std::max(peak,
+                        std::abs(std::sin(2 * std::numbers::pi * t) +
+                                 0.5 * std::cos(2 * std::numbers::pi * 3 * t)));
+    }
+    for (size_t i = 0; i < table_type::size; ++i)
+    {
+        auto t        = static_cast<double>(i) / table_type::size;
+        auto expected = (std::sin(2 * std::numbers::pi * t) +
+                         0.5 * std::cos(2 * std::numbers::pi * 3 * t)) /
+                        peak;
+        REQUIRE(std::abs(level[i].as<double>() - expected) < 1e-3);
+    }
+}
+
+TEST_CASE("wavetable oscillator interpolates between samples",
+          "[dsp|wavetable]")
+{
+    std::vector<double> fundamental{1.0};
+    auto sine = table_type::from_harmonics(fundamental);
+    auto increment = bit::dsp::phase_increment(440, 48000);
+    bit::dsp::wavetable_oscillator oscillator{sine, increment};
+    std::vector<sample_type> block(1000);
+    oscillator.render(std::span{block}.first(300));
+    oscillator.render(std::span{block}.subspan(300));
+
+    auto peak = std::numeric_limits<sample_type>::max().as<double>();
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        auto phase    = increment.as<double>() * static_cast<double>(i);
+        auto expected = peak * std::sin(2 * std::numbers::pi * phase);
+        INFO("Sample: " << i);
+        // linear interpolation error of a 2048 point sine is ~1.2e-6
+        REQUIRE(std::abs(block[i].as<double>() - expected) < 2e-4);
+    }
+}
+
+TEST_CASE("wavetable oscillator throughput", "[.benchmark][dsp|wavetable]")
+{
+    std::vector<sample_type> block(4096);
+    bit::dsp::wavetable_oscillator oscillator{
+        saw_table(), bit::dsp::phase_increment(440, 48000)};
+
+    BENCHMARK("wavetable saw, 4096 samples")
+    {
+        oscillator.render(block);
+        return block.back();
+    };
+
+    BENCHMARK("building a 2048 x 10 table set")
+    {
+        return table_type::from_harmonics(saw_harmonics()).level(0)[1];
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace bit::io
+{
+// Read-only memory map of a whole file, so that it is paged in on demand
+// instead of copied. An empty file maps to an empty span.
+class mapped_file
+{
+    const uint8_t* _data = nullptr;
+    size_t _size         = 0;
+#if defined(_WIN32)
+    void* _mapping = nullptr;
+#endif
+
+    void unmap() noexcept;
+
+  public:
+    // throws std::runtime_error when the file can't be opened or mapped
+    explicit mapped_file(const std::filesystem::path& path);
+    ~mapped_file();
+
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    [[nodiscard]] std::span<const uint8_t> bytes() const noexcept
+    {
+        return {_data, _size};
+    }
+};
+} // namespace bit::io
@@ -0,0 +1,154 @@
+#include <io/mapped_file.h>
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bit::io
+{
+namespace
+{
+[[noreturn]] void fail(const std::filesystem::path& path, const char* what)
+{
+    throw std::runtime_error{std::string{"Could not "} + what +
+                             " file at " + path.string()};
+}
+} // namespace
+
+#if defined(_WIN32)
+mapped_file::mapped_file(const std::filesystem::path& path)
+{
+    auto file = CreateFileW(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        fail(path, "open");
+    }
+    LARGE_INTEGER size{};
+    if (not GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        fail(path, "open");
+    }
+    if (size.QuadPart > 0)
+    {
+        // the view keeps the mapping and the file alive
+        _mapping =
+            CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (_mapping == nullptr)
+        {
+            fail(path, "map");
+        }
+        _data = static_cast<const uint8_t*>(
+            MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (_data == nullptr)
+        {
+            CloseHandle(_mapping);
+            fail(path, "map");
+        }
+        _size = static_cast<size_t>(size.QuadPart);
+    }
+    else
+    {
+        CloseHandle(file);
+    }
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapping);
+    }
+}
+#else
+mapped_file::mapped_file(const std::filesystem::path& path)
+{
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        fail(path, "open");
+    }
+    struct stat status
+    {
+    };
+    if (::fstat(file, &status) != 0)
+    {
+        ::close(file);
+        fail(path, "open");
+    }
+    if (status.st_size > 0)
+    {
+        auto size = static_cast<size_t>(status.st_size);
+        // the mapping stays valid after the descriptor is closed
+        auto* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (data == MAP_FAILED)
+        {
+            fail(path, "map");
+        }
+        // the formats mapped so far are read front to back
+        ::madvise(data, size, MADV_SEQUENTIAL);
+        _data = static_cast<const uint8_t*>(data);
+        _size = size;
+    }
+    else
+    {
+        ::close(file);
+    }
+}
+
+void mapped_file::unmap() noexcept
+{
+    if (_data != nullptr)
+    {
+        ::munmap(const_cast<uint8_t*>(_data), _size);
+    }
+}
+#endif
+
+mapped_file::~mapped_file()
+{
+    unmap();
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : _data{std::exchange(other._data, nullptr)},
+      _size{std::exchange(other._size, 0)}
+#if defined(_WIN32)
+      ,
+      _mapping{std::exchange(other._mapping, nullptr)}
+#endif
+{
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        _data = std::exchange(other._data, nullptr);
+        _size = std::exchange(other._size, 0);
+#if defined(_WIN32)
+        _mapping = std::exchange(other._mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+} // namespace bit::io
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace bit
+{
+// Sum of ProductQ values kept in a fixed container with GuardBits extra
+// integer bits. Up to 2^GuardBits full scale products can be accumulated
+// without overflow, so mac() never clamps and a dot product loop has no
+// branches; saturation happens once, when the sum is narrowed.
+template <qformatted ProductQ, size_t GuardBits = 8>
+    requires(ProductQ::bits + GuardBits <= (ProductQ::is_signed
+                                                ? widest_signed_container
+                                                : widest_unsigned_container))
+class accumulator
+{
+  public:
+    using product_type = ProductQ;
+
+    auto static constexpr guard_bits    = GuardBits;
+    auto static constexpr integer_bits  = ProductQ::integer_bits + GuardBits;
+    auto static constexpr fraction_bits = ProductQ::fraction_bits;
+    auto static constexpr is_signed     = ProductQ::is_signed;
+
+    using value_type =
+        typename value_type_for<integer_bits, fraction_bits, is_signed>::type;
+    using sum_type = qnumber<integer_bits, fraction_bits, value_type>;
+
+  private:
+    value_type value_{};
+
+  public:
+    constexpr accumulator() = default;
+
+    template <qformatted ArgT>
+        requires(ArgT::fraction_bits == fraction_bits and
+                 ArgT::integer_bits <= ProductQ::integer_bits)
+    constexpr explicit accumulator(ArgT initial) noexcept
+        : value_{static_cast<value_type>(initial.raw())}
+    {
+    }
+
+    // accumulates lhs * rhs at full product precision
+    template <qformatted LhsT, qformatted RhsT>
+        requires(LhsT::fraction_bits + RhsT::fraction_bits == fraction_bits and
+                 LhsT::integer_bits + RhsT::integer_bits <=
+                     ProductQ::integer_bits and
+                 (is_signed or not(LhsT::is_signed or RhsT::is_signed)))
+    constexpr void mac(LhsT lhs, RhsT rhs) noexcept
+    {
+        auto lhs_raw = static_cast<value_type>(lhs.raw());
+        auto rhs_raw = static_cast<value_type>(rhs.raw());
+        value_       = static_cast<value_type>(value_ + lhs_raw * rhs_raw);
+    }
+
+    // subtracts lhs * rhs, without negating an operand which could be lowest()
+    template <qformatted LhsT, qformatted RhsT>
+        requires(LhsT::fraction_bits + RhsT::fraction_bits == fraction_bits and
+                 LhsT::integer_bits + RhsT::integer_bits <=
+                     ProductQ::integer_bits and
+                 is_signed)
+    constexpr void msu(LhsT lhs, RhsT rhs) noexcept
+    {
+        auto lhs_raw = static_cast<value_type>(lhs.raw());
+        auto rhs_raw = static_cast<value_type>(rhs.raw());
+        value_       = static_cast<value_type>(value_ - lhs_raw * rhs_raw);
+    }
+
+    template <qformatted ArgT>
+        requires(ArgT::fraction_bits == fraction_bits and
+                 ArgT::integer_bits <= ProductQ::integer_bits and
+                 (is_signed or not ArgT::is_signed))
+    constexpr void add(ArgT argument) noexcept
+    {
+        auto argument_raw = static_cast<value_type>(argument.raw());
+        value_            = static_cast<value_type>(value_ + argument_raw);
+    }
+
+    constexpr void reset() noexcept
+    {
+        value_ = 0;
+    }
+
+    [[nodiscard]] constexpr sum_type value() const noexcept
+    {
+        return {as_is_t{value_}};
+    }
+
+    // the only place where the sum is clamped
+    template <qformatted ToT>
+    [[nodiscard]] constexpr ToT narrow_as() const noexcept
+    {
+        static_assert(ToT::fraction_bits <= fraction_bits,
+                      "narrowing can't add fraction bits");
+        if constexpr (safely_convertible<sum_type, ToT>)
+        {
+            return value().template as<ToT>();
+        }
+        else
+        {
+            return value().template narrow_as<ToT>();
+        }
+    }
+};
+
+template <qformatted LhsT, qformatted RhsT, size_t GuardBits = 8>
+using product_accumulator =
+    accumulator<decltype(std::declval<LhsT>().accurate_multiply(
+                    std::declval<RhsT>())),
+                GuardBits>;
+
+// sum of lhs[i] * rhs[i], at most 2^GuardBits terms
+template <size_t GuardBits = 8, qformatted LhsT, qformatted RhsT>
+[[nodiscard]] constexpr product_accumulator<LhsT, RhsT, GuardBits> dot(
+    std::span<const LhsT> lhs, std::span<const RhsT> rhs) noexcept
+{
+    assert(lhs.size() == rhs.size());
+    assert(GuardBits >= 64 or lhs.size() <= (size_t{1} << GuardBits));
+
+    product_accumulator<LhsT, RhsT, GuardBits> sum;
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        sum.mac(lhs[i], rhs[i]);
+    }
+    return sum;
+}
+
+static_assert(
+    std::same_as<product_accumulator<qs<0, 15>, qs<0, 15>>::sum_type,
+                 qs<8, 30>>);
+static_assert(
+    std::same_as<product_accumulator<qs<0, 15>, qs<0, 15>>::value_type,
+                 int64_t>);
+} // namespace bit
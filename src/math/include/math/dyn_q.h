@@ -0,0 +1,141 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace bit
+{
+// Runtime-selected signed Q format. The (integer_bits, fraction_bits) pair is
+// resolved once per dispatch through a jump table built at compile time, so
+// the kernel always runs on a fully specialized qs<I, F> and pays no per-sample
+// cost for the format being chosen at runtime.
+//
+// A kernel is any callable accepting std::type_identity<qs<I, F>> followed by
+// the forwarded arguments, e.g.
+//
+//     format.dispatch([]<qformatted Q>(std::type_identity<Q>, auto block) {
+//         ...
+//     }, block);
+//
+// Every specialization has to return the same type.
+template <size_t MaxIntegerBits, size_t MaxFractionBits>
+    requires signed_container_exists<MaxIntegerBits, MaxFractionBits>
+class dyn_q
+{
+  public:
+    auto static constexpr max_integer_bits  = MaxIntegerBits;
+    auto static constexpr max_fraction_bits = MaxFractionBits;
+    auto static constexpr formats =
+        (max_integer_bits + 1) * (max_fraction_bits + 1);
+
+    template <size_t Index>
+        requires(Index < formats)
+    using format_at = qs<Index / (max_fraction_bits + 1),
+                         Index % (max_fraction_bits + 1)>;
+
+  private:
+    size_t integer_bits_  = 0;
+    size_t fraction_bits_ = max_fraction_bits;
+
+    template <typename KernelT, typename... ArgsT>
+    using result_t = std::invoke_result_t<KernelT&,
+                                          std::type_identity<format_at<0>>,
+                                          ArgsT&&...>;
+
+    template <size_t Index, typename KernelT, typename... ArgsT>
+    static result_t<KernelT, ArgsT...> invoke_(KernelT& kernel,
+                                               ArgsT&&... args)
+    {
+        using format = format_at<Index>;
+        static_assert(
+            std::same_as<result_t<KernelT, ArgsT...>,
+                         std::invoke_result_t<KernelT&,
+                                              std::type_identity<format>,
+                                              ArgsT&&...>>,
+            "kernel has to return the same type for every q format");
+        return kernel(std::type_identity<format>{},
+                      std::forward<ArgsT>(args)...);
+    }
+
+    template <typename KernelT, typename... ArgsT, size_t... Indices>
+    static consteval auto make_jump_table_(std::index_sequence<Indices...>)
+    {
+        using entry_type =
+            result_t<KernelT, ArgsT...> (*)(KernelT&, ArgsT&&...);
+        return std::array<entry_type, formats>{
+            &invoke_<Indices, KernelT, ArgsT...>...};
+    }
+
+    [[nodiscard]] constexpr size_t index_() const noexcept
+    {
+        return integer_bits_ * (max_fraction_bits + 1) + fraction_bits_;
+    }
+
+  public:
+    constexpr dyn_q() = default;
+
+    constexpr dyn_q(size_t integer_bits, size_t fraction_bits)
+    {
+        set_format(integer_bits, fraction_bits);
+    }
+
+    template <qformatted Q>
+        requires Q::is_signed
+    [[nodiscard]] static constexpr dyn_q of() noexcept
+    {
+        static_assert(Q::integer_bits <= max_integer_bits and
+                          Q::fraction_bits <= max_fraction_bits,
+                      "q format exceeds dyn_q bounds");
+        return {Q::integer_bits, Q::fraction_bits};
+    }
+
+    constexpr void set_format(size_t integer_bits, size_t fraction_bits)
+    {
+        if (integer_bits > max_integer_bits or
+            fraction_bits > max_fraction_bits)
+        {
+            throw std::range_error{"q format exceeds dyn_q bounds"};
+        }
+        integer_bits_  = integer_bits;
+        fraction_bits_ = fraction_bits;
+    }
+
+    [[nodiscard]] constexpr size_t integer_bits() const noexcept
+    {
+        return integer_bits_;
+    }
+
+    [[nodiscard]] constexpr size_t fraction_bits() const noexcept
+    {
+        return fraction_bits_;
+    }
+
+    [[nodiscard]] constexpr size_t bits() const noexcept
+    {
+        return integer_bits_ + fraction_bits_;
+    }
+
+    constexpr bool operator==(const dyn_q&) const noexcept = default;
+
+    template <typename KernelT, typename... ArgsT>
+    decltype(auto) dispatch(KernelT&& kernel, ArgsT&&... args) const
+    {
+        using kernel_type = std::remove_reference_t<KernelT>;
+        static constexpr auto jump_table =
+            make_jump_table_<kernel_type, ArgsT...>(
+                std::make_index_sequence<formats>{});
+        return jump_table[index_()](kernel, std::forward<ArgsT>(args)...);
+    }
+};
+
+static_assert(std::same_as<dyn_q<3, 15>::format_at<0>, qs<0, 0>>);
+static_assert(std::same_as<dyn_q<3, 15>::format_at<17>, qs<1, 1>>);
+static_assert(std::same_as<dyn_q<3, 15>::format_at<63>, qs<3, 15>>);
+static_assert(dyn_q<3, 15>::of<qs<2, 7>>() == dyn_q<3, 15>{2, 7});
+} // namespace bit
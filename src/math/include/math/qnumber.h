@@ -3,6 +3,7 @@
 #include "math/bits.h"
 #include "math/qnumber/round.h"
 #include "math/utilities.h"
+#include "math/wide.h"
 
 #include <algorithm>
 #include <bit>
@@ -17,9 +18,11 @@
 namespace bit
 {
 template <size_t IntegerBits, size_t FractionBits>
-concept signed_container_exists = IntegerBits + FractionBits <= 63;
+concept signed_container_exists =
+    IntegerBits + FractionBits <= widest_signed_container;
 template <size_t IntegerBits, size_t FractionBits>
-concept unsigned_container_exists = IntegerBits + FractionBits <= 64;
+concept unsigned_container_exists =
+    IntegerBits + FractionBits <= widest_unsigned_container;
 
 template <size_t IntegerBits, size_t FractionBits>
     requires signed_container_exists<IntegerBits, FractionBits>
@@ -35,6 +38,10 @@ consteval auto compute_minimal_signed_type()
         return int32_t{};
     else if constexpr (width<int64_t>() >= total_bits)
         return int64_t{};
+#if defined(BIT_HAS_INT128)
+    else if constexpr (has_int128_containers)
+        return int128_t{};
+#endif
     else
     {
         std::unreachable();
@@ -58,6 +65,10 @@ consteval auto compute_minimal_unsigned_type()
         return uint32_t{};
     else if constexpr (width<uint64_t>() >= total_bits)
         return uint64_t{};
+#if defined(BIT_HAS_INT128)
+    else if constexpr (has_int128_containers)
+        return uint128_t{};
+#endif
     else
     {
         std::unreachable();
@@ -156,7 +167,7 @@ struct value_type_for<IntegerBits, FractionBits, IsSigned>
 };
 
 constexpr std::array powers_of_two = [] {
-    std::array<long double, 65> power{};
+    std::array<long double, 129> power{};
     power[0] = 1;
     for (size_t i = 1; i < power.size(); ++i)
     {
@@ -490,8 +501,50 @@ class qnumber
         ArgT multiplicant) const noexcept
         requires(SaturateIntoT::is_signed == is_signed or ArgT::is_signed)
     {
-        auto result = this->accurate_multiply(multiplicant);
-        return result.template narrow_as<SaturateIntoT>();
+        constexpr size_t product_integer_bits =
+            integer_bits + ArgT::integer_bits;
+        constexpr size_t product_fraction_bits =
+            fraction_bits + ArgT::fraction_bits;
+        constexpr bool product_is_signed = is_signed or ArgT::is_signed;
+        constexpr bool product_container_exists =
+            product_is_signed
+                ? signed_container_exists<product_integer_bits,
+                                          product_fraction_bits>
+                : unsigned_container_exists<product_integer_bits,
+                                            product_fraction_bits>;
+
+        if constexpr (product_container_exists)
+        {
+            auto result = this->accurate_multiply(multiplicant);
+            return result.template narrow_as<SaturateIntoT>();
+        }
+        else
+        {
+            // no container for the full product, keep it in two words and
+            // narrow it straight into the result
+            static_assert(sizeof(value_type) <= 8 and
+                              sizeof(typename ArgT::value_type) <= 8,
+                          "operands wider than 64 bits are not supported");
+            static_assert(not product_is_signed or (bits < 64 and
+                                                    ArgT::bits < 64),
+                          "unsigned 64-bit operand can't be mixed with signed");
+            static_assert(product_fraction_bits >=
+                              SaturateIntoT::fraction_bits,
+                          "requested result type is not narrower");
+
+            using word_type =
+                std::conditional_t<product_is_signed, int64_t, uint64_t>;
+            using result_value_type = typename SaturateIntoT::value_type;
+            auto product =
+                multiply_wide(static_cast<word_type>(raw()),
+                              static_cast<word_type>(multiplicant.raw()));
+            auto result = saturate_shift_right<result_value_type>(
+                product,
+                product_fraction_bits - SaturateIntoT::fraction_bits,
+                std::numeric_limits<SaturateIntoT>::lowest().raw(),
+                std::numeric_limits<SaturateIntoT>::max().raw());
+            return SaturateIntoT{as_is_t{result}};
+        }
     }
 
     template <qformatted ArgT>
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+namespace bit
+{
+struct conversion_result
+{
+    size_t converted{};
+    // number of samples clamped into the destination format, NaNs included
+    size_t saturated{};
+};
+
+// Bulk floating -> fixed conversion. In-range values produce exactly the same
+// raw value as the scalar qnumber constructor (round half away from zero),
+// out-of-range values saturate and are only counted, so the loop has no
+// branches, no exceptions and vectorizes.
+template <qformatted Q, std::floating_point FloatingT>
+conversion_result from_floats(std::span<const FloatingT> from,
+                              std::span<Q> to) noexcept
+{
+    assert(from.size() <= to.size());
+
+    // wide enough to represent every raw value and add 0.5 to it exactly
+    using compute_type =
+        std::conditional_t<(Q::bits < std::numeric_limits<double>::digits),
+                           std::common_type_t<FloatingT, double>,
+                           long double>;
+    using value_type = typename Q::value_type;
+
+    constexpr auto scale =
+        static_cast<compute_type>(powers_of_two[Q::fraction_bits]);
+    constexpr auto lowest =
+        static_cast<compute_type>(std::numeric_limits<Q>::lowest().raw());
+    constexpr auto max =
+        static_cast<compute_type>(std::numeric_limits<Q>::max().raw());
+    constexpr auto half = static_cast<compute_type>(0.5);
+
+    size_t saturated = 0;
+    for (size_t i = 0; i < from.size(); ++i)
+    {
+        auto scaled = static_cast<compute_type>(from[i]) * scale;
+        // negated so that NaN is counted as well
+        saturated += static_cast<size_t>(
+            not(lowest - half < scaled and scaled < max + half));
+        // NaN fails both comparisons and lands on lowest
+        auto clamped = std::max(lowest, std::min(scaled, max));
+        // conversion truncates, which makes it round half away from zero
+        to[i] = Q{as_is_t{static_cast<value_type>(
+            clamped + std::copysign(half, clamped))}};
+    }
+    return {from.size(), saturated};
+}
+
+template <qformatted Q, std::floating_point FloatingT>
+conversion_result from_floats(std::span<FloatingT> from,
+                              std::span<Q> to) noexcept
+{
+    return from_floats(std::span<const FloatingT>{from}, to);
+}
+
+// Bulk fixed -> floating conversion, matches qnumber::as<FloatingT>().
+template <std::floating_point FloatingT, qformatted Q>
+conversion_result to_floats(std::span<const Q> from,
+                            std::span<FloatingT> to) noexcept
+{
+    assert(from.size() <= to.size());
+
+    constexpr auto scale =
+        static_cast<FloatingT>(1.L / powers_of_two[Q::fraction_bits]);
+
+    for (size_t i = 0; i < from.size(); ++i)
+    {
+        to[i] = static_cast<FloatingT>(from[i].raw()) * scale;
+    }
+    return {from.size(), 0};
+}
+
+template <std::floating_point FloatingT, qformatted Q>
+conversion_result to_floats(std::span<Q> from,
+                            std::span<FloatingT> to) noexcept
+{
+    return to_floats(std::span<const Q>{from}, to);
+}
+} // namespace bit
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "math/qnumber.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+// Division through a reciprocal estimate instead of a hardware divide.
+//
+// The divisor magnitude is normalized into [0.5, 1), a 256 entry seed table
+// gives 1/x to ~9 bits and two Newton-Raphson steps y = y * (2 - x * y) in
+// Q2.30 refine it. The estimate has relative error below 2^-28 (checked by
+// fast_divide_test.cpp), the final shift into the result format rounds to
+// nearest, which adds half an lsb. Hence, for a result format of B bits:
+//
+//     |fast_divide<R>(a, b) - a / b| <= fast_divide_error_lsb<R> lsb of R
+//
+// which is 1 lsb for every format up to 27 bits, e.g. qs<0, 15>, qs<3, 24>,
+// and doubles with every bit above that, e.g. 9 lsb for qs<0, 31>.
+namespace bit
+{
+template <qformatted ResultQ>
+constexpr uint64_t fast_divide_error_lsb =
+    ResultQ::bits < 28 ? 1 : 1 + (uint64_t{1} << (ResultQ::bits - 28));
+
+static_assert(fast_divide_error_lsb<qs<0, 15>> == 1);
+static_assert(fast_divide_error_lsb<qs<0, 31>> == 9);
+
+namespace detail::fast_divide
+{
+constexpr size_t seed_bits = 8;
+
+// 1 / x in Q2.30 for x in the middle of each [0.5, 1) subinterval
+constexpr std::array seeds = [] {
+    std::array<uint32_t, 1 << seed_bits> seeds{};
+    for (size_t i = 0; i < seeds.size(); ++i)
+    {
+        auto x = 0.5 + (i + 0.5) / (2 * seeds.size());
+        seeds[i] = static_cast<uint32_t>(tl::ullround((1 << 30) / x));
+    }
+    return seeds;
+}();
+
+// magnitude ~= y * 2^-exponent, relative error below 2^-28
+struct reciprocal_estimate
+{
+    uint64_t y{};
+    int exponent{};
+};
+
+[[nodiscard]] constexpr reciprocal_estimate estimate(
+    uint64_t magnitude) noexcept
+{
+    assert(magnitude != 0);
+    auto leading = std::countl_zero(magnitude);
+    // top 32 bits of the normalized magnitude, x in [0.5, 1) as Q0.32
+    auto x = static_cast<uint32_t>((magnitude << leading) >> 32);
+
+    // y = y * (2 - x * y), every step doubles the number of correct bits
+    auto refine = [x](uint64_t y) {
+        constexpr auto two = uint64_t{1} << 63; // 2 in Q2.62
+        auto correction    = (two - x * y) >> 32;
+        return (y * correction) >> 30;
+    };
+    uint64_t seed = seeds[(x >> (31 - seed_bits)) & (seeds.size() - 1)];
+    return {refine(refine(seed)), 94 - leading};
+}
+
+// product * 2^-shift, saturated into limit
+[[nodiscard]] constexpr uint64_t scale(uint64_t product,
+                                       int shift,
+                                       uint64_t limit) noexcept
+{
+    auto right        = static_cast<unsigned>(shift) & 63u;
+    auto left         = static_cast<unsigned>(-shift) & 63u;
+    // round to nearest, product is below 2^63 so adding half can't overflow
+    auto half         = right == 0 ? 0 : uint64_t{1} << (right - 1);
+    auto shifted_down = shift >= 64 ? 0 : (product + half) >> right;
+    auto overflows    = shift <= -64 or product > (limit >> left);
+    auto shifted_up   = overflows ? limit : product << left;
+    auto magnitude    = shift >= 0 ? shifted_down : shifted_up;
+    return magnitude < limit ? magnitude : limit;
+}
+
+template <qformatted Q>
+[[nodiscard]] constexpr uint64_t magnitude(Q value) noexcept
+{
+    static_assert(sizeof(typename Q::value_type) <= 8,
+                  "operands wider than 64 bits are not supported");
+    auto raw = value.raw();
+    if constexpr (Q::is_signed)
+    {
+        auto as_unsigned = static_cast<uint64_t>(static_cast<int64_t>(raw));
+        return raw < 0 ? 0 - as_unsigned : as_unsigned;
+    }
+    else
+    {
+        return static_cast<uint64_t>(raw);
+    }
+}
+
+template <qformatted ResultQ>
+[[nodiscard]] constexpr ResultQ make_result(uint64_t magnitude,
+                                            int shift,
+                                            bool negative,
+                                            bool divisor_is_zero) noexcept
+{
+    using value_type = typename ResultQ::value_type;
+    constexpr auto max =
+        static_cast<uint64_t>(std::numeric_limits<ResultQ>::max().raw());
+
+    if constexpr (ResultQ::is_signed)
+    {
+        // lowest() is one lsb further away from zero than max()
+        auto limit = max + static_cast<uint64_t>(negative);
+        auto scaled =
+            divisor_is_zero ? limit : scale(magnitude, shift, limit);
+        auto raw = static_cast<int64_t>(negative ? 0 - scaled : scaled);
+        return {as_is_t{static_cast<value_type>(raw)}};
+    }
+    else
+    {
+        auto scaled = divisor_is_zero ? max : scale(magnitude, shift, max);
+        return {as_is_t{static_cast<value_type>(negative ? 0 : scaled)}};
+    }
+}
+} // namespace detail::fast_divide
+
+// 1 / divisor saturated into ResultQ, division by zero saturates as well
+template <qformatted ResultQ, qformatted DivisorQ>
+[[nodiscard]] constexpr ResultQ reciprocal(DivisorQ divisor) noexcept
+{
+    namespace fd = detail::fast_divide;
+    auto magnitude = fd::magnitude(divisor);
+    auto is_zero   = magnitude == 0;
+    auto estimate  = fd::estimate(magnitude | is_zero);
+    auto shift =
+        estimate.exponent -
+        static_cast<int>(DivisorQ::fraction_bits + ResultQ::fraction_bits);
+    return fd::make_result<ResultQ>(
+        estimate.y, shift, divisor.is_negative(), is_zero);
+}
+
+// dividend / divisor saturated into ResultQ, the dividend magnitude has to
+// fit on 32 bits so that it can be multiplied by the reciprocal estimate
+// without a wider intermediate
+template <qformatted ResultQ, qformatted DividendQ, qformatted DivisorQ>
+    requires(DividendQ::bits <= 32)
+[[nodiscard]] constexpr ResultQ fast_divide(DividendQ dividend,
+                                            DivisorQ divisor) noexcept
+{
+    namespace fd = detail::fast_divide;
+    auto magnitude = fd::magnitude(divisor);
+    auto is_zero   = magnitude == 0;
+    auto estimate  = fd::estimate(magnitude | is_zero);
+    auto shift =
+        estimate.exponent + static_cast<int>(DividendQ::fraction_bits) -
+        static_cast<int>(DivisorQ::fraction_bits + ResultQ::fraction_bits);
+    auto negative = dividend.is_negative() != divisor.is_negative();
+    return fd::make_result<ResultQ>(fd::magnitude(dividend) * estimate.y,
+                                    shift,
+                                    negative and not dividend.is_zero(),
+                                    is_zero and not dividend.is_zero());
+}
+
+// Block division by a common divisor, the reciprocal is estimated once and
+// the loop is left with a multiply and a shift per sample.
+template <qformatted ResultQ, qformatted DividendQ, qformatted DivisorQ>
+    requires(DividendQ::bits <= 32)
+void fast_divide(std::span<const DividendQ> dividends,
+                 DivisorQ divisor,
+                 std::span<ResultQ> results) noexcept
+{
+    assert(dividends.size() <= results.size());
+    namespace fd = detail::fast_divide;
+
+    auto magnitude = fd::magnitude(divisor);
+    auto is_zero   = magnitude == 0;
+    auto estimate  = fd::estimate(magnitude | is_zero);
+    auto shift =
+        estimate.exponent + static_cast<int>(DividendQ::fraction_bits) -
+        static_cast<int>(DivisorQ::fraction_bits + ResultQ::fraction_bits);
+
+    if (is_zero or shift < 1 or shift > 63)
+    {
+        // far out of the usual range, take the saturating scalar path
+        for (size_t i = 0; i < dividends.size(); ++i)
+        {
+            results[i] = fast_divide<ResultQ>(dividends[i], divisor);
+        }
+        return;
+    }
+
+    using value_type = typename ResultQ::value_type;
+    constexpr auto lowest =
+        static_cast<int64_t>(std::numeric_limits<ResultQ>::lowest().raw());
+    constexpr auto max =
+        static_cast<int64_t>(std::numeric_limits<ResultQ>::max().raw());
+
+    auto y    = static_cast<int64_t>(estimate.y);
+    y         = divisor.is_negative() ? -y : y;
+    auto half = int64_t{1} << (shift - 1);
+    for (size_t i = 0; i < dividends.size(); ++i)
+    {
+        auto product  = static_cast<int64_t>(dividends[i].raw()) * y;
+        // same round half away from zero as the scalar path
+        auto quotient = (product + half - (product < 0)) >> shift;
+        results[i]    = {as_is_t{static_cast<value_type>(
+            std::max(lowest, std::min(quotient, max)))}};
+    }
+}
+
+// Block division with a divisor per lane.
+template <qformatted ResultQ, qformatted DividendQ, qformatted DivisorQ>
+    requires(DividendQ::bits <= 32)
+void fast_divide(std::span<const DividendQ> dividends,
+                 std::span<const DivisorQ> divisors,
+                 std::span<ResultQ> results) noexcept
+{
+    assert(dividends.size() == divisors.size());
+    assert(dividends.size() <= results.size());
+
+    for (size_t i = 0; i < dividends.size(); ++i)
+    {
+        results[i] = fast_divide<ResultQ>(dividends[i], divisors[i]);
+    }
+}
+} // namespace bit
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "math/bits.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace bit
+{
+#if defined(__SIZEOF_INT128__)
+#define BIT_HAS_INT128 1
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+
+// 128-bit integers are only usable as qnumber containers when the standard
+// library treats them as integral, e.g. gcc with GNU extensions enabled (cmake
+// default) or clang with libc++
+constexpr bool has_int128_containers =
+    std::integral<int128_t> and std::integral<uint128_t>;
+#else
+constexpr bool has_int128_containers = false;
+#endif
+
+// widest integer and fraction bits sum which still has a container
+constexpr size_t widest_signed_container   = has_int128_containers ? 127 : 63;
+constexpr size_t widest_unsigned_container = has_int128_containers ? 128 : 64;
+
+// Full product of two 64-bit words, split into high and low word so that it
+// is available without a 128-bit container (MSVC).
+template <std::integral T>
+    requires(sizeof(T) == 8)
+struct two_words
+{
+    T high{};
+    uint64_t low{};
+
+    constexpr bool operator==(const two_words&) const noexcept = default;
+};
+
+[[nodiscard]] constexpr two_words<uint64_t> multiply_wide(
+    uint64_t lhs, uint64_t rhs) noexcept
+{
+#if defined(BIT_HAS_INT128)
+    // single mul / mulx on x86-64, mul + umulh on arm64
+    auto product = static_cast<uint128_t>(lhs) * rhs;
+    return {static_cast<uint64_t>(product >> 64),
+            static_cast<uint64_t>(product)};
+#else
+    if (not std::is_constant_evaluated())
+    {
+#if defined(_M_X64)
+        uint64_t high{};
+        auto low = _umul128(lhs, rhs, &high);
+        return {high, low};
+#elif defined(_M_ARM64)
+        return {__umulh(lhs, rhs), lhs * rhs};
+#endif
+    }
+
+    constexpr uint64_t low_half = 0xFFFF'FFFF;
+    auto lhs_low   = lhs & low_half;
+    auto lhs_high  = lhs >> 32;
+    auto rhs_low   = rhs & low_half;
+    auto rhs_high  = rhs >> 32;
+    auto low_low   = lhs_low * rhs_low;
+    auto high_low  = lhs_high * rhs_low;
+    auto low_high  = lhs_low * rhs_high;
+    auto high_high = lhs_high * rhs_high;
+
+    auto middle = (low_low >> 32) + (high_low & low_half) + low_high;
+    return {high_high + (high_low >> 32) + (middle >> 32),
+            (middle << 32) | (low_low & low_half)};
+#endif
+}
+
+[[nodiscard]] constexpr two_words<int64_t> multiply_wide(
+    int64_t lhs, int64_t rhs) noexcept
+{
+    auto product = multiply_wide(static_cast<uint64_t>(lhs),
+                                 static_cast<uint64_t>(rhs));
+    // unsigned product of two's complement operands differs from the signed
+    // one only in the high word
+    auto high = product.high;
+    high -= lhs < 0 ? static_cast<uint64_t>(rhs) : 0;
+    high -= rhs < 0 ? static_cast<uint64_t>(lhs) : 0;
+    return {static_cast<int64_t>(high), product.low};
+}
+
+// value >> shift saturated into [lowest, max], shift in [0, 127]
+template <std::integral ResultT, std::integral T>
+[[nodiscard]] constexpr ResultT saturate_shift_right(two_words<T> value,
+                                                     size_t shift,
+                                                     ResultT lowest,
+                                                     ResultT max) noexcept
+{
+    auto high = value.high;
+    auto low  = value.low;
+    if (shift >= 64)
+    {
+        low  = static_cast<uint64_t>(high >> std::min<size_t>(shift - 64, 63));
+        high = high >> 63;
+        if constexpr (not std::is_signed_v<T>)
+        {
+            low  = shift >= 128 ? 0 : low;
+            high = 0;
+        }
+    }
+    else if (shift > 0)
+    {
+        low  = (low >> shift) | (static_cast<uint64_t>(high) << (64 - shift));
+        high = high >> shift;
+    }
+
+    if constexpr (std::is_signed_v<T>)
+    {
+        // fits on 64 bits when the high word only extends the sign of low
+        if (high != (static_cast<int64_t>(low) >> 63))
+        {
+            return high < 0 ? lowest : max;
+        }
+        return static_cast<ResultT>(
+            bit::clamp(static_cast<int64_t>(low), lowest, max));
+    }
+    else
+    {
+        if (high != 0)
+        {
+            return max;
+        }
+        return static_cast<ResultT>(bit::clamp(low, lowest, max));
+    }
+}
+
+static_assert(multiply_wide(~uint64_t{}, ~uint64_t{}) ==
+              two_words<uint64_t>{~uint64_t{} - 1, 1});
+static_assert(multiply_wide(int64_t{-1}, int64_t{1}) ==
+              two_words<int64_t>{-1, ~uint64_t{}});
+static_assert(multiply_wide(int64_t{1} << 62, int64_t{-4}) ==
+              two_words<int64_t>{-1, 0});
+
+static_assert(saturate_shift_right(
+                  two_words<int64_t>{-1, 0}, 60, int64_t{-100}, int64_t{99}) ==
+              -16);
+static_assert(saturate_shift_right(
+                  two_words<int64_t>{1, 0}, 60, int64_t{-100}, int64_t{99}) ==
+              16);
+static_assert(saturate_shift_right(
+                  two_words<int64_t>{1, 0}, 0, int64_t{-100}, int64_t{99}) ==
+              99);
+static_assert(saturate_shift_right(
+                  two_words<int64_t>{-2, 0}, 64, int64_t{-100}, int64_t{99}) ==
+              -2);
+static_assert(saturate_shift_right(two_words<uint64_t>{1, 0},
+                                   65,
+                                   uint64_t{0},
+                                   ~uint64_t{}) == 0);
+} // namespace bit
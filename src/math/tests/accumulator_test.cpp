@@ -0,0 +1,116 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <math/accumulator.h>
+
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+using sample_type = bit::qs<0, 15>;
+
+std::vector<sample_type> random_samples(size_t size, uint64_t seed)
+{
+    std::mt19937_64 generator{seed};
+    std::uniform_int_distribution<int> distribution(
+        std::numeric_limits<sample_type>::lowest().raw(),
+        std::numeric_limits<sample_type>::max().raw());
+    std::vector<sample_type> samples(size);
+    for (auto& sample : samples)
+    {
+        sample = bit::as_is_t{static_cast<int16_t>(distribution(generator))};
+    }
+    return samples;
+}
+} // namespace
+
+TEST_CASE("accumulator keeps full product precision", "[accumulator]")
+{
+    auto lhs = random_samples(256, 1);
+    auto rhs = random_samples(256, 2);
+
+    bit::product_accumulator<sample_type, sample_type> sum;
+    long double expected = 0;
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        sum.mac(lhs[i], rhs[i]);
+        expected += lhs[i].as<long double>() * rhs[i].as<long double>();
+    }
+    CHECK(sum.value().as<long double>() == expected);
+}
+
+TEST_CASE("accumulator doesn't overflow for 2^GuardBits full scale products",
+          "[accumulator]")
+{
+    constexpr auto lowest = std::numeric_limits<sample_type>::lowest();
+    bit::product_accumulator<sample_type, sample_type, 4> sum;
+    for (auto i : bit::loop_i(16))
+    {
+        (void)i;
+        sum.mac(lowest, lowest);
+    }
+    CHECK(sum.value().as<double>() == 16.0);
+}
+
+TEST_CASE("accumulator saturates once when narrowed", "[accumulator]")
+{
+    constexpr auto max    = std::numeric_limits<sample_type>::max();
+    constexpr auto lowest = std::numeric_limits<sample_type>::lowest();
+    bit::product_accumulator<sample_type, sample_type> sum;
+
+    sum.mac(max, max);
+    sum.mac(max, max);
+    CHECK(sum.narrow_as<sample_type>() == max);
+
+    sum.reset();
+    sum.mac(lowest, max);
+    sum.mac(lowest, max);
+    CHECK(sum.narrow_as<sample_type>() == lowest);
+
+    sum.reset();
+    sum.mac(sample_type{0.5f}, sample_type{0.5f});
+    sum.add(bit::qs<0, 30>{0.125});
+    CHECK(sum.narrow_as<sample_type>() == sample_type{0.375f});
+    CHECK(sum.narrow_as<bit::qs<10, 30>>().as<double>() == 0.375);
+}
+
+TEST_CASE("dot() equals mac() loop", "[accumulator]")
+{
+    auto lhs = random_samples(128, 3);
+    auto rhs = random_samples(128, 4);
+
+    bit::product_accumulator<sample_type, sample_type> expected;
+    for (size_t i = 0; i < lhs.size(); ++i)
+    {
+        expected.mac(lhs[i], rhs[i]);
+    }
+    auto sum = bit::dot(std::span<const sample_type>{lhs},
+                        std::span<const sample_type>{rhs});
+    CHECK(sum.value() == expected.value());
+}
+
+TEST_CASE("accumulator against per-step saturation",
+          "[.benchmark][accumulator]")
+{
+    auto lhs = random_samples(256, 5);
+    auto rhs = random_samples(256, 6);
+
+    BENCHMARK("saturate_multiply() + saturate_add(), 256 taps")
+    {
+        sample_type sum{0.f};
+        for (size_t i = 0; i < lhs.size(); ++i)
+        {
+            sum = sum.saturate_add(lhs[i].saturate_multiply(rhs[i]));
+        }
+        return sum;
+    };
+
+    BENCHMARK("dot() + narrow_as(), 256 taps")
+    {
+        return bit::dot(std::span<const sample_type>{lhs},
+                        std::span<const sample_type>{rhs})
+            .narrow_as<sample_type>();
+    };
+}
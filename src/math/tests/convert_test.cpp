@@ -0,0 +1,130 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <math/qnumber/convert.h>
+
+#include <cmath>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace
+{
+template <bit::qformatted Q> std::vector<float> in_range_floats(size_t size)
+{
+    constexpr auto lowest =
+        std::numeric_limits<Q>::lowest().template as<float>();
+    constexpr auto max = std::numeric_limits<Q>::max().template as<float>();
+    std::vector<float> values(size);
+    bit::linear_space(
+        std::begin(values), std::end(values), lowest * 0.999f, max * 0.999f);
+    return values;
+}
+
+template <bit::qformatted Q> void check_matches_scalar_constructor()
+{
+    auto floats = in_range_floats<Q>(4097);
+    std::vector<Q> converted(floats.size());
+
+    auto result = bit::from_floats(std::span{floats}, std::span{converted});
+    CHECK(result.converted == floats.size());
+    CHECK(result.saturated == 0);
+
+    for (size_t i = 0; i < floats.size(); ++i)
+    {
+        INFO("Value: " << floats[i]);
+        REQUIRE(converted[i].raw() == Q{floats[i]}.raw());
+    }
+}
+} // namespace
+
+TEST_CASE("from_floats() matches scalar constructor for in-range values",
+          "[convert]")
+{
+    check_matches_scalar_constructor<bit::qs<0, 7>>();
+    check_matches_scalar_constructor<bit::qs<0, 15>>();
+    check_matches_scalar_constructor<bit::qs<3, 12>>();
+    check_matches_scalar_constructor<bit::qs<0, 31>>();
+    check_matches_scalar_constructor<bit::qu<1, 7>>();
+    check_matches_scalar_constructor<bit::qu<4, 20>>();
+    check_matches_scalar_constructor<bit::qs<2, 60>>();
+}
+
+TEST_CASE("from_floats() saturates and counts out-of-range values",
+          "[convert]")
+{
+    using q = bit::qs<0, 7>;
+    std::vector<float> floats{-4.f,
+                              -1.f,
+                              0.5f,
+                              0.999f,
+                              2.f,
+                              std::numeric_limits<float>::quiet_NaN()};
+    std::vector<q> converted(floats.size());
+
+    auto result = bit::from_floats(std::span{floats}, std::span{converted});
+
+    CHECK(result.saturated == 4);
+    CHECK(converted[0] == std::numeric_limits<q>::lowest());
+    CHECK(converted[1] == std::numeric_limits<q>::lowest());
+    CHECK(converted[2].raw() == 64);
+    CHECK(converted[3] == std::numeric_limits<q>::max());
+    CHECK(converted[4] == std::numeric_limits<q>::max());
+    CHECK(converted[5] == std::numeric_limits<q>::lowest());
+}
+
+TEST_CASE("from_floats() saturates negative values into unsigned format",
+          "[convert]")
+{
+    std::vector<float> floats{-0.25f, 0.25f};
+    std::vector<bit::qu<0, 8>> converted(floats.size());
+
+    auto result = bit::from_floats(std::span{floats}, std::span{converted});
+
+    CHECK(result.saturated == 1);
+    CHECK(converted[0].raw() == 0);
+    CHECK(converted[1].raw() == 64);
+}
+
+TEST_CASE("to_floats() matches qnumber::as<float>()", "[convert]")
+{
+    using q     = bit::qs<3, 12>;
+    auto floats = in_range_floats<q>(1024);
+    std::vector<q> converted(floats.size());
+    std::vector<float> round_trip(floats.size());
+
+    bit::from_floats(std::span{floats}, std::span{converted});
+    bit::to_floats(std::span{converted}, std::span{round_trip});
+
+    for (size_t i = 0; i < converted.size(); ++i)
+    {
+        REQUIRE(round_trip[i] == converted[i].as<float>());
+    }
+}
+
+TEST_CASE("bulk conversion against scalar constructor",
+          "[.benchmark][convert]")
+{
+    using q     = bit::qs<0, 15>;
+    auto floats = in_range_floats<q>(4096);
+    std::vector<q> converted(floats.size());
+    std::vector<float> back(floats.size());
+
+    BENCHMARK("scalar qs<0, 15> constructor, 4096 samples")
+    {
+        for (size_t i = 0; i < floats.size(); ++i)
+        {
+            converted[i] = q{floats[i]};
+        }
+        return converted.back();
+    };
+
+    BENCHMARK("from_floats() qs<0, 15>, 4096 samples")
+    {
+        return bit::from_floats(std::span{floats}, std::span{converted});
+    };
+
+    BENCHMARK("to_floats() qs<0, 15>, 4096 samples")
+    {
+        return bit::to_floats(std::span{converted}, std::span{back});
+    };
+}
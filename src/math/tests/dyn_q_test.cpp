@@ -0,0 +1,88 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <math/dyn_q.h>
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct crush_kernel
+{
+    template <bit::qformatted Q>
+    float operator()(std::type_identity<Q>,
+                     std::span<float> block) const noexcept
+    {
+        auto sum = 0.f;
+        for (auto& sample : block)
+        {
+            sample = Q{sample}.template as<float>();
+            sum += sample;
+        }
+        return sum;
+    }
+};
+
+std::vector<float> make_block(size_t size)
+{
+    std::vector<float> block(size);
+    bit::linear_space(std::begin(block), std::end(block), -0.99f, 0.99f);
+    return block;
+}
+} // namespace
+
+TEST_CASE("dyn_q dispatches to qs<> matching runtime format", "[dyn_q]")
+{
+    auto format_of = []<bit::qformatted Q>(std::type_identity<Q>) {
+        return std::pair{Q::integer_bits, Q::fraction_bits};
+    };
+
+    bit::dyn_q<3, 15> format{2, 9};
+    CHECK(format.dispatch(format_of) == std::pair<size_t, size_t>{2, 9});
+
+    format.set_format(0, 15);
+    CHECK(format.dispatch(format_of) == std::pair<size_t, size_t>{0, 15});
+
+    format.set_format(3, 0);
+    CHECK(format.dispatch(format_of) == std::pair<size_t, size_t>{3, 0});
+}
+
+TEST_CASE("dyn_q rejects formats outside of its bounds", "[dyn_q]")
+{
+    bit::dyn_q<3, 15> format;
+    CHECK_THROWS_AS(format.set_format(4, 0), std::range_error);
+    CHECK_THROWS_AS(format.set_format(0, 16), std::range_error);
+    CHECK_THROWS_AS((bit::dyn_q<3, 15>{1, 20}), std::range_error);
+}
+
+TEST_CASE("dyn_q kernel output matches statically typed call", "[dyn_q]")
+{
+    auto dispatched = make_block(256);
+    auto direct     = dispatched;
+
+    auto format = bit::dyn_q<3, 15>::of<bit::qs<0, 7>>();
+    format.dispatch(crush_kernel{}, std::span{dispatched});
+    crush_kernel{}(std::type_identity<bit::qs<0, 7>>{}, std::span{direct});
+
+    CHECK(dispatched == direct);
+}
+
+TEST_CASE("dyn_q dispatch overhead", "[.benchmark][dyn_q]")
+{
+    auto block  = make_block(512);
+    auto format = bit::dyn_q<3, 15>::of<bit::qs<0, 15>>();
+
+    BENCHMARK("direct qs<0, 15> kernel, 512 samples")
+    {
+        return crush_kernel{}(std::type_identity<bit::qs<0, 15>>{},
+                              std::span{block});
+    };
+
+    BENCHMARK("dyn_q dispatched kernel, 512 samples")
+    {
+        return format.dispatch(crush_kernel{}, std::span{block});
+    };
+}
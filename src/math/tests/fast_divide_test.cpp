@@ -0,0 +1,216 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <math/qnumber/fast_divide.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+template <bit::qformatted Q> Q random_q(std::mt19937_64& generator)
+{
+    using value_type = typename Q::value_type;
+    std::uniform_int_distribution<int64_t> distribution(
+        std::numeric_limits<Q>::lowest().raw(),
+        std::numeric_limits<Q>::max().raw());
+    return {bit::as_is_t{static_cast<value_type>(distribution(generator))}};
+}
+
+template <bit::qformatted ResultQ,
+          bit::qformatted DividendQ,
+          bit::qformatted DivisorQ>
+void check_error_bound()
+{
+    constexpr auto lowest =
+        std::numeric_limits<ResultQ>::lowest().template as<long double>();
+    constexpr auto max =
+        std::numeric_limits<ResultQ>::max().template as<long double>();
+    constexpr auto lsb = 1.L / bit::powers_of_two[ResultQ::fraction_bits];
+
+    std::mt19937_64 generator{ResultQ::bits};
+    for (auto i : bit::loop_i(100'000))
+    {
+        (void)i;
+        auto dividend = random_q<DividendQ>(generator);
+        auto divisor  = random_q<DivisorQ>(generator);
+        if (divisor.is_zero())
+        {
+            continue;
+        }
+        auto exact = dividend.template as<long double>() /
+                     divisor.template as<long double>();
+        auto fast  = bit::fast_divide<ResultQ>(dividend, divisor);
+
+        INFO("Dividend: " << dividend.template as<double>()
+                          << ", divisor: " << divisor.template as<double>());
+        if (exact > max)
+        {
+            REQUIRE(fast == std::numeric_limits<ResultQ>::max());
+        }
+        else if (exact < lowest)
+        {
+            REQUIRE(fast == std::numeric_limits<ResultQ>::lowest());
+        }
+        else
+        {
+            auto error = std::abs(fast.template as<long double>() - exact);
+            REQUIRE(error <= bit::fast_divide_error_lsb<ResultQ> * lsb);
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("reciprocal estimate relative error is below 2^-28",
+          "[fast_divide]")
+{
+    std::mt19937_64 generator{};
+    for (auto i : bit::loop_i(1'000'000))
+    {
+        (void)i;
+        auto magnitude = generator() >> (generator() % 64);
+        if (magnitude == 0)
+        {
+            continue;
+        }
+        auto [y, exponent] = bit::detail::fast_divide::estimate(magnitude);
+        auto exact         = 1.L / magnitude;
+        auto estimate      = std::ldexp(static_cast<long double>(y), -exponent);
+        REQUIRE(std::abs(estimate - exact) / exact < std::ldexp(1.L, -28));
+    }
+}
+
+TEST_CASE("fast_divide() stays within documented error bound",
+          "[fast_divide]")
+{
+    check_error_bound<bit::qs<3, 12>, bit::qs<0, 15>, bit::qs<0, 15>>();
+    check_error_bound<bit::qs<7, 24>, bit::qs<0, 15>, bit::qs<3, 12>>();
+    check_error_bound<bit::qs<0, 31>, bit::qs<0, 31>, bit::qs<1, 30>>();
+    check_error_bound<bit::qu<4, 12>, bit::qu<1, 15>, bit::qu<8, 8>>();
+    check_error_bound<bit::qs<15, 16>, bit::qs<0, 7>, bit::qs<20, 40>>();
+}
+
+TEST_CASE("reciprocal() of powers of two is exact", "[fast_divide]")
+{
+    using q = bit::qs<7, 8>;
+    CHECK(bit::reciprocal<q>(bit::qs<3, 4>{2.f}) == q{0.5f});
+    CHECK(bit::reciprocal<q>(bit::qs<3, 4>{-0.25f}) == q{-4.f});
+    CHECK(bit::reciprocal<q>(bit::qs<3, 4>{1.f}) == q{1.f});
+}
+
+TEST_CASE("fast_divide() by zero saturates", "[fast_divide]")
+{
+    using q = bit::qs<3, 12>;
+    constexpr bit::qs<0, 15> zero{0.f};
+    CHECK(bit::fast_divide<q>(bit::qs<0, 15>{0.5f}, zero) ==
+          std::numeric_limits<q>::max());
+    CHECK(bit::fast_divide<q>(bit::qs<0, 15>{-0.5f}, zero) ==
+          std::numeric_limits<q>::lowest());
+    CHECK(bit::fast_divide<q>(zero, zero).is_zero());
+}
+
+TEST_CASE("fast_divide() saturates negative result into unsigned format",
+          "[fast_divide]")
+{
+    auto result = bit::fast_divide<bit::qu<3, 12>>(bit::qs<0, 15>{-0.5f},
+                                                   bit::qs<0, 15>{0.25f});
+    CHECK(result.is_zero());
+}
+
+TEST_CASE("block fast_divide() matches scalar fast_divide()", "[fast_divide]")
+{
+    using dividend_type = bit::qs<0, 15>;
+    using result_type   = bit::qs<3, 12>;
+    std::mt19937_64 generator{};
+    std::vector<dividend_type> dividends(1000);
+    std::vector<dividend_type> divisors(dividends.size());
+    for (auto i : bit::loop_i(dividends.size()))
+    {
+        dividends[i] = random_q<dividend_type>(generator);
+        divisors[i]  = random_q<dividend_type>(generator);
+    }
+    std::vector<result_type> results(dividends.size());
+
+    SECTION("common divisor")
+    {
+        bit::fast_divide(std::span<const dividend_type>{dividends},
+                         divisors.front(),
+                         std::span{results});
+        for (auto i : bit::loop_i(dividends.size()))
+        {
+            REQUIRE(results[i] == bit::fast_divide<result_type>(
+                                      dividends[i], divisors.front()));
+        }
+    }
+
+    SECTION("per-lane divisor")
+    {
+        bit::fast_divide(std::span<const dividend_type>{dividends},
+                         std::span<const dividend_type>{divisors},
+                         std::span{results});
+        for (auto i : bit::loop_i(dividends.size()))
+        {
+            REQUIRE(results[i] == bit::fast_divide<result_type>(dividends[i],
+                                                                divisors[i]));
+        }
+    }
+}
+
+TEST_CASE("fast_divide() against saturate_divide()",
+          "[.benchmark][fast_divide]")
+{
+    using dividend_type = bit::qs<0, 15>;
+    using result_type   = bit::qs<3, 12>;
+    std::mt19937_64 generator{};
+    std::vector<dividend_type> dividends(4096);
+    std::vector<dividend_type> divisors(dividends.size());
+    for (auto i : bit::loop_i(dividends.size()))
+    {
+        dividends[i] = random_q<dividend_type>(generator);
+        divisors[i]  = random_q<dividend_type>(generator);
+        if (divisors[i].is_zero())
+        {
+            divisors[i] = std::numeric_limits<dividend_type>::min();
+        }
+    }
+    std::vector<result_type> results(dividends.size());
+
+    BENCHMARK("saturate_divide(), per-lane divisor, 4096 samples")
+    {
+        for (auto i : bit::loop_i(dividends.size()))
+        {
+            results[i] =
+                dividends[i].saturate_divide<result_type>(divisors[i]);
+        }
+        return results.back();
+    };
+
+    BENCHMARK("fast_divide(), per-lane divisor, 4096 samples")
+    {
+        bit::fast_divide(std::span<const dividend_type>{dividends},
+                         std::span<const dividend_type>{divisors},
+                         std::span{results});
+        return results.back();
+    };
+
+    BENCHMARK("saturate_divide(), common divisor, 4096 samples")
+    {
+        for (auto i : bit::loop_i(dividends.size()))
+        {
+            results[i] =
+                dividends[i].saturate_divide<result_type>(divisors.front());
+        }
+        return results.back();
+    };
+
+    BENCHMARK("fast_divide(), common divisor, 4096 samples")
+    {
+        bit::fast_divide(std::span<const dividend_type>{dividends},
+                         divisors.front(),
+                         std::span{results});
+        return results.back();
+    };
+}
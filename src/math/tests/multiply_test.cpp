@@ -33,3 +33,66 @@ TEST_CASE("saturate: max() unsigned qformat * -1 * max() signed qformat")
     [[maybe_unused]] auto r_f = result.as<float>();
     CHECK(result.is_nearest_to(-60.0625f));
 }
+
+namespace
+{
+template <bit::qformatted LhsQ, bit::qformatted RhsQ>
+void check_wide_accurate_multiply(LhsQ lhs, RhsQ rhs, long double expected)
+{
+    if constexpr (bit::signed_container_exists<LhsQ::integer_bits +
+                                                   RhsQ::integer_bits,
+                                               LhsQ::fraction_bits +
+                                                   RhsQ::fraction_bits>)
+    {
+        auto result = lhs.accurate_multiply(rhs);
+        static_assert(decltype(result)::bits == LhsQ::bits + RhsQ::bits);
+#if defined(BIT_HAS_INT128)
+        static_assert(std::same_as<typename decltype(result)::value_type,
+                                   bit::int128_t>);
+#endif
+        CHECK(result.template as<long double>() == expected);
+    }
+    else
+    {
+        SKIP("no 128-bit container on this platform");
+    }
+}
+} // namespace
+
+TEST_CASE("accurate: product wider than 63 bits uses 128-bit container")
+{
+    constexpr auto a = std::numeric_limits<bit::qs<0, 32>>::max();
+    constexpr auto b = std::numeric_limits<bit::qs<1, 31>>::lowest();
+    check_wide_accurate_multiply(
+        a, b, a.as<long double>() * b.as<long double>());
+}
+
+TEST_CASE("saturate: product wider than 63 bits into 32-bit qformat")
+{
+    constexpr bit::qs<0, 32> a{0.75};
+    constexpr bit::qs<1, 31> b{-1.25};
+    auto result = a.saturate_multiply<bit::qs<0, 31>>(b);
+    CHECK(result.as<double>() == -0.9375);
+}
+
+TEST_CASE("saturate: product wider than 63 bits clamps to result bounds")
+{
+    constexpr auto a = std::numeric_limits<bit::qs<0, 32>>::max();
+    constexpr auto b = std::numeric_limits<bit::qs<1, 31>>::lowest();
+    auto result      = a.saturate_multiply<bit::qs<0, 31>>(b);
+    CHECK(result == std::numeric_limits<bit::qs<0, 31>>::lowest());
+}
+
+TEST_CASE("multiply_wide() matches long multiplication")
+{
+    constexpr auto max = std::numeric_limits<int64_t>::max();
+    constexpr auto min = std::numeric_limits<int64_t>::min();
+    CHECK(bit::multiply_wide(max, max) ==
+          bit::two_words<int64_t>{max >> 1, 1});
+    CHECK(bit::multiply_wide(min, min) ==
+          bit::two_words<int64_t>{int64_t{1} << 62, 0});
+    CHECK(bit::multiply_wide(min, int64_t{1}) ==
+          bit::two_words<int64_t>{-1, uint64_t{1} << 63});
+    CHECK(bit::multiply_wide(uint64_t{1} << 63, uint64_t{4}) ==
+          bit::two_words<uint64_t>{2, 0});
+}
@@ -0,0 +1,340 @@
+#pragma once
+
+#include "io/mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace bit::midi
+{
+enum class message : uint8_t
+{
+    note_off         = 0x80,
+    note_on          = 0x90,
+    key_pressure     = 0xa0,
+    control_change   = 0xb0,
+    program_change   = 0xc0,
+    channel_pressure = 0xd0,
+    pitch_bend       = 0xe0,
+};
+
+// channel voice message at an absolute tick
+struct event
+{
+    uint64_t tick;
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+
+    [[nodiscard]] constexpr message type() const noexcept
+    {
+        return static_cast<message>(status & 0xf0);
+    }
+
+    [[nodiscard]] constexpr uint8_t channel() const noexcept
+    {
+        return status & 0x0f;
+    }
+
+    // note on with velocity 0 is a note off
+    [[nodiscard]] constexpr bool is_note_on() const noexcept
+    {
+        return type() == message::note_on and data2 > 0;
+    }
+
+    [[nodiscard]] constexpr bool is_note_off() const noexcept
+    {
+        return type() == message::note_off or
+               (type() == message::note_on and data2 == 0);
+    }
+};
+
+struct tempo_change
+{
+    uint64_t tick;
+    uint32_t microseconds_per_quarter;
+};
+
+// Decodes one track chunk in place, an event at a time. Meta events other
+// than tempo changes and system exclusive messages are skipped.
+class track_reader
+{
+    std::span<const uint8_t> _data;
+    size_t _position = 0;
+    uint64_t _tick   = 0;
+    uint8_t _running = 0;
+
+  public:
+    explicit track_reader(std::span<const uint8_t> data) noexcept
+        : _data{data}
+    {
+    }
+
+    // the next channel message, or nullopt at the end of the track; tempo
+    // changes on the way are handed to on_tempo. Throws std::runtime_error
+    // on malformed data.
+    template <typename OnTempo>
+    std::optional<event> next(OnTempo&& on_tempo);
+
+    std::optional<event> next()
+    {
+        return next([](const tempo_change&) {});
+    }
+};
+
+// Tempo map precomputed for one sampling frequency: every segment starts
+// at a tempo change, at the frame reached by all segments before it.
+class tempo_map
+{
+    struct segment
+    {
+        uint64_t tick;
+        double frame;
+        double frames_per_tick;
+    };
+
+    std::vector<segment> _segments;
+
+  public:
+    tempo_map(std::span<const tempo_change> changes,
+              uint16_t ticks_per_quarter,
+              double sampling_frequency);
+
+    // of the tick, fractional
+    [[nodiscard]] double position(uint64_t tick) const noexcept;
+
+    // of the tick, rounded to the nearest frame
+    [[nodiscard]] uint64_t frame(uint64_t tick) const noexcept;
+};
+
+// Standard MIDI File, format 0 or 1, with ticks per quarter note timing.
+//
+// The file is memory mapped and nothing is decoded up front except the
+// tempo map: events() walks all tracks at once through a k-way merge on a
+// heap of track readers, decoding variable length quantities as it goes,
+// and neither copies the events nor allocates per event.
+class smf
+{
+    std::optional<io::mapped_file> _file;
+    uint16_t _format   = 0;
+    uint16_t _division = 0;
+    std::vector<std::span<const uint8_t>> _tracks;
+    std::vector<tempo_change> _tempo;
+
+    void parse(std::span<const uint8_t> bytes);
+
+  public:
+    // merged events of all tracks, in time order and in track order at the
+    // same tick; a single pass
+    class merged_events
+    {
+        struct cursor
+        {
+            track_reader reader;
+            event current;
+            size_t track;
+        };
+
+        std::vector<cursor> _heap;
+        std::optional<event> _current;
+
+        void advance();
+
+      public:
+        struct sentinel
+        {
+        };
+
+        class iterator
+        {
+            merged_events* _events = nullptr;
+
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type       = event;
+            using difference_type  = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(merged_events& events) noexcept
+                : _events{&events}
+            {
+            }
+
+            const event& operator*() const noexcept
+            {
+                return *_events->_current;
+            }
+
+            const event* operator->() const noexcept
+            {
+                return &*_events->_current;
+            }
+
+            iterator& operator++()
+            {
+                _events->advance();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            bool operator==(sentinel) const noexcept
+            {
+                return not _events->_current;
+            }
+        };
+
+        explicit merged_events(
+            std::span<const std::span<const uint8_t>> tracks);
+
+        [[nodiscard]] iterator begin() noexcept
+        {
+            return iterator{*this};
+        }
+
+        [[nodiscard]] sentinel end() const noexcept
+        {
+            return {};
+        }
+    };
+
+    // throws std::runtime_error when the file can't be read or isn't a
+    // supported SMF
+    explicit smf(const std::filesystem::path& path);
+    // the bytes must outlive the smf
+    explicit smf(std::span<const uint8_t> bytes);
+
+    [[nodiscard]] uint16_t format() const noexcept
+    {
+        return _format;
+    }
+
+    [[nodiscard]] size_t tracks() const noexcept
+    {
+        return _tracks.size();
+    }
+
+    [[nodiscard]] uint16_t ticks_per_quarter() const noexcept
+    {
+        return _division;
+    }
+
+    // throws std::runtime_error on malformed track data
+    [[nodiscard]] merged_events events() const
+    {
+        return merged_events{_tracks};
+    }
+
+    [[nodiscard]] const std::vector<tempo_change>&
+    tempo_changes() const noexcept
+    {
+        return _tempo;
+    }
+
+    // 120 bpm until the first tempo change
+    [[nodiscard]] tempo_map timing(double sampling_frequency) const
+    {
+        return {_tempo, _division, sampling_frequency};
+    }
+};
+
+// Variable length quantity: 7 bits per byte, most significant first, the
+// top bit set on every byte but the last. Advances position past it.
+[[nodiscard]] uint32_t read_vlq(std::span<const uint8_t> bytes,
+                                size_t& position);
+
+namespace detail
+{
+[[noreturn]] void malformed(const char* what);
+
+inline void require(bool condition, const char* what)
+{
+    if (not condition)
+    {
+        malformed(what);
+    }
+}
+
+inline uint32_t read_big_endian(std::span<const uint8_t> bytes,
+                                size_t position,
+                                size_t size)
+{
+    require(position + size <= bytes.size(), "SMF: truncated file");
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        value = value << 8 | bytes[position + i];
+    }
+    return value;
+}
+
+// data bytes following a channel status byte
+constexpr size_t data_bytes(uint8_t status) noexcept
+{
+    auto type = status & 0xf0;
+    return type == 0xc0 or type == 0xd0 ? 1 : 2;
+}
+} // namespace detail
+
+template <typename OnTempo>
+std::optional<event> track_reader::next(OnTempo&& on_tempo)
+{
+    using detail::require;
+    while (_position < _data.size())
+    {
+        _tick += read_vlq(_data, _position);
+        require(_position < _data.size(), "SMF: truncated event");
+        auto status = _data[_position];
+        if (status == 0xff)
+        {
+            require(_position + 1 < _data.size(), "SMF: truncated event");
+            auto type = _data[_position + 1];
+            _position += 2;
+            auto length = read_vlq(_data, _position);
+            require(_position + length <= _data.size(),
+                    "SMF: truncated meta event");
+            if (type == 0x51 and length == 3)
+            {
+                on_tempo(tempo_change{
+                    _tick, detail::read_big_endian(_data, _position, 3)});
+            }
+            // nothing follows the end of track
+            _position = type == 0x2f ? _data.size() : _position + length;
+            continue;
+        }
+        if (status == 0xf0 or status == 0xf7)
+        {
+            ++_position;
+            auto length = read_vlq(_data, _position);
+            require(_position + length <= _data.size(),
+                    "SMF: truncated system exclusive");
+            _position += length;
+            continue;
+        }
+        if (status & 0x80)
+        {
+            _running = status;
+            ++_position;
+        }
+        require(_running != 0, "SMF: data byte without a status");
+        auto count = detail::data_bytes(_running);
+        require(_position + count <= _data.size(), "SMF: truncated event");
+        event decoded{_tick,
+                      _running,
+                      _data[_position],
+                      count == 2 ? _data[_position + 1] : uint8_t{}};
+        _position += count;
+        return decoded;
+    }
+    return std::nullopt;
+}
+} // namespace bit::midi
@@ -0,0 +1,179 @@
+#include <midi/smf.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+
+namespace bit::midi
+{
+namespace
+{
+constexpr uint32_t default_tempo = 500'000;
+
+using detail::read_big_endian;
+using detail::require;
+
+bool has_tag(std::span<const uint8_t> bytes,
+             size_t position,
+             std::string_view tag)
+{
+    return position + tag.size() <= bytes.size() and
+           std::equal(tag.begin(), tag.end(), bytes.begin() + position);
+}
+
+// the heap keeps the earliest event on top, the first track on ties
+template <typename Cursor>
+bool later(const Cursor& left, const Cursor& right) noexcept
+{
+    return left.current.tick != right.current.tick
+               ? left.current.tick > right.current.tick
+               : left.track > right.track;
+}
+} // namespace
+
+void detail::malformed(const char* what)
+{
+    throw std::runtime_error{what};
+}
+
+uint32_t read_vlq(std::span<const uint8_t> bytes, size_t& position)
+{
+    uint32_t value = 0;
+    // at most 4 bytes, 28 bits
+    for (size_t i = 0; i < 4; ++i)
+    {
+        require(position < bytes.size(), "SMF: truncated quantity");
+        auto byte = bytes[position++];
+        value     = value << 7 | (byte & 0x7f);
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    throw std::runtime_error{"SMF: variable length quantity too long"};
+}
+
+tempo_map::tempo_map(std::span<const tempo_change> changes,
+                     uint16_t ticks_per_quarter,
+                     double sampling_frequency)
+{
+    auto frames_per_tick = [&](uint32_t tempo) {
+        return tempo * 1e-6 * sampling_frequency / ticks_per_quarter;
+    };
+    _segments.reserve(changes.size() + 1);
+    _segments.push_back({0, 0.0, frames_per_tick(default_tempo)});
+    for (const auto& change : changes)
+    {
+        auto& last = _segments.back();
+        auto frame = last.frame + static_cast<double>(change.tick - last.tick) *
+                                      last.frames_per_tick;
+        auto rate  = frames_per_tick(change.microseconds_per_quarter);
+        if (change.tick == last.tick)
+        {
+            // the later of the changes at the same tick wins
+            last.frames_per_tick = rate;
+            continue;
+        }
+        _segments.push_back({change.tick, frame, rate});
+    }
+}
+
+double tempo_map::position(uint64_t tick) const noexcept
+{
+    auto after = std::ranges::upper_bound(_segments, tick, {}, &segment::tick);
+    const auto& in = *std::prev(after);
+    return in.frame + static_cast<double>(tick - in.tick) * in.frames_per_tick;
+}
+
+uint64_t tempo_map::frame(uint64_t tick) const noexcept
+{
+    return static_cast<uint64_t>(std::llround(position(tick)));
+}
+
+smf::merged_events::merged_events(
+    std::span<const std::span<const uint8_t>> tracks)
+{
+    _heap.reserve(tracks.size());
+    for (size_t track = 0; track < tracks.size(); ++track)
+    {
+        track_reader reader{tracks[track]};
+        if (auto first = reader.next())
+        {
+            _heap.push_back({reader, *first, track});
+        }
+    }
+    std::ranges::make_heap(_heap, later<cursor>);
+    advance();
+}
+
+void smf::merged_events::advance()
+{
+    if (_heap.empty())
+    {
+        _current.reset();
+        return;
+    }
+    std::ranges::pop_heap(_heap, later<cursor>);
+    auto& top = _heap.back();
+    _current  = top.current;
+    if (auto next = top.reader.next())
+    {
+        top.current = *next;
+        std::ranges::push_heap(_heap, later<cursor>);
+    }
+    else
+    {
+        _heap.pop_back();
+    }
+}
+
+smf::smf(const std::filesystem::path& path) : _file{std::in_place, path}
+{
+    parse(_file->bytes());
+}
+
+smf::smf(std::span<const uint8_t> bytes)
+{
+    parse(bytes);
+}
+
+void smf::parse(std::span<const uint8_t> bytes)
+{
+    require(has_tag(bytes, 0, "MThd"), "SMF: missing header chunk");
+    auto header_size = read_big_endian(bytes, 4, 4);
+    require(header_size >= 6, "SMF: header chunk too short");
+    _format     = static_cast<uint16_t>(read_big_endian(bytes, 8, 2));
+    auto tracks = read_big_endian(bytes, 10, 2);
+    _division   = static_cast<uint16_t>(read_big_endian(bytes, 12, 2));
+    require(_format <= 1, "SMF: only formats 0 and 1 are supported");
+    require((_division & 0x8000) == 0 and _division > 0,
+            "SMF: SMPTE timing isn't supported");
+
+    size_t chunk = 8 + size_t{header_size};
+    _tracks.reserve(tracks);
+    while (_tracks.size() < tracks)
+    {
+        auto size = size_t{read_big_endian(bytes, chunk + 4, 4)};
+        require(chunk + 8 + size <= bytes.size(), "SMF: truncated chunk");
+        // unknown chunks are skipped
+        if (has_tag(bytes, chunk, "MTrk"))
+        {
+            _tracks.push_back(bytes.subspan(chunk + 8, size));
+        }
+        chunk += 8 + size;
+    }
+
+    // in format 1 the first track holds the tempo map
+    if (not _tracks.empty())
+    {
+        track_reader conductor{_tracks.front()};
+        auto on_tempo = [&](const tempo_change& change) {
+            _tempo.push_back(change);
+        };
+        while (conductor.next(on_tempo))
+        {
+        }
+    }
+}
+} // namespace bit::midi
@@ -0,0 +1,230 @@
+#include <midi/smf.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+using bytes = std::vector<uint8_t>;
+
+void append(bytes& to, std::initializer_list<uint8_t> values)
+{
+    to.insert(to.end(), values);
+}
+
+bytes chunk(const char* tag, const bytes& data)
+{
+    bytes result{tag, tag + 4};
+    auto size = static_cast<uint32_t>(data.size());
+    append(result,
+           {static_cast<uint8_t>(size >> 24),
+            static_cast<uint8_t>(size >> 16),
+            static_cast<uint8_t>(size >> 8),
+            static_cast<uint8_t>(size)});
+    result.insert(result.end(), data.begin(), data.end());
+    return result;
+}
+
+bytes file(uint16_t format,
+           uint16_t division,
+           std::initializer_list<bytes> tracks)
+{
+    auto count = static_cast<uint16_t>(tracks.size());
+    auto result =
+        chunk("MThd",
+              {0,
+               static_cast<uint8_t>(format),
+               static_cast<uint8_t>(count >> 8),
+               static_cast<uint8_t>(count),
+               static_cast<uint8_t>(division >> 8),
+               static_cast<uint8_t>(division)});
+    for (const auto& track : tracks)
+    {
+        auto encoded = chunk("MTrk", track);
+        result.insert(result.end(), encoded.begin(), encoded.end());
+    }
+    return result;
+}
+
+const bytes end_of_track{0x00, 0xff, 0x2f, 0x00};
+
+std::vector<bit::midi::event> all_events(const bit::midi::smf& song)
+{
+    std::vector<bit::midi::event> events;
+    for (const auto& each : song.events())
+    {
+        events.push_back(each);
+    }
+    return events;
+}
+} // namespace
+
+TEST_CASE("variable length quantities decode", "[midi|smf]")
+{
+    auto decode = [](bytes encoded) {
+        size_t position = 0;
+        auto value      = bit::midi::read_vlq(encoded, position);
+        REQUIRE(position == encoded.size());
+        return value;
+    };
+    REQUIRE(decode({0x00}) == 0);
+    REQUIRE(decode({0x7f}) == 0x7f);
+    REQUIRE(decode({0x81, 0x00}) == 0x80);
+    REQUIRE(decode({0xc0, 0x00}) == 0x2000);
+    REQUIRE(decode({0xff, 0xff, 0x7f}) == 0x1fffff);
+    REQUIRE(decode({0xff, 0xff, 0xff, 0x7f}) == 0x0fffffff);
+
+    size_t position = 0;
+    REQUIRE_THROWS_AS(bit::midi::read_vlq(bytes{0x81, 0x80}, position),
+                      std::runtime_error);
+    position = 0;
+    REQUIRE_THROWS_AS(
+        bit::midi::read_vlq(bytes{0x81, 0x80, 0x80, 0x80, 0x00}, position),
+        std::runtime_error);
+}
+
+TEST_CASE("tracks merge in time order with running status", "[midi|smf]")
+{
+    bytes melody{0x00, 0x90, 60, 100, 0x60, 62, 90, 0x60, 60, 0, 0x00, 62, 0};
+    melody.insert(melody.end(), end_of_track.begin(), end_of_track.end());
+    bytes bass{0x00, 0xc1, 33, 0x81, 0x40, 0x81, 36, 64};
+    bass.insert(bass.end(), end_of_track.begin(), end_of_track.end());
+
+    auto encoded = file(1, 96, {melody, bass});
+    bit::midi::smf song{encoded};
+    REQUIRE(song.format() == 1);
+    REQUIRE(song.tracks() == 2);
+    REQUIRE(song.ticks_per_quarter() == 96);
+
+    auto events = all_events(song);
+    REQUIRE(events.size() == 6);
+    REQUIRE(events[0].tick == 0);
+    REQUIRE(events[0].is_note_on());
+    REQUIRE(events[1].type() == bit::midi::message::program_change);
+    REQUIRE(events[1].channel() == 1);
+    REQUIRE(events[1].data1 == 33);
+    REQUIRE(events[2].tick == 96);
+    REQUIRE(events[2].data1 == 62);
+    // the same tick keeps track order
+    REQUIRE(events[3].tick == 192);
+    REQUIRE(events[3].is_note_off());
+    REQUIRE(events[4].tick == 192);
+    REQUIRE(events[4].is_note_off());
+    REQUIRE(events[5].tick == 192);
+    REQUIRE(events[5].type() == bit::midi::message::note_off);
+    REQUIRE(events[5].data1 == 36);
+}
+
+TEST_CASE("ticks convert to frames through the tempo map", "[midi|smf]")
+{
+    // 120 bpm, then 60 bpm from the second quarter, sysex is skipped
+    bytes track{0x00, 0xf0, 0x03, 0x7e, 0x09, 0xf7, 0x78, 0xff, 0x51,
+                0x03, 0x0f, 0x42, 0x40, 0x00, 0x90, 64,   100};
+    track.insert(track.end(), end_of_track.begin(), end_of_track.end());
+
+    auto encoded = file(0, 120, {track});
+    bit::midi::smf song{encoded};
+    REQUIRE(song.tempo_changes().size() == 1);
+    REQUIRE(song.tempo_changes()[0].tick == 120);
+    REQUIRE(song.tempo_changes()[0].microseconds_per_quarter == 1'000'000);
+    auto events = all_events(song);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].tick == 120);
+
+    auto timing = song.timing(1000);
+    REQUIRE(timing.position(0) == Catch::Approx(0.0));
+    REQUIRE(timing.position(60) == Catch::Approx(250.0));
+    REQUIRE(timing.position(120) == Catch::Approx(500.0));
+    REQUIRE(timing.position(180) == Catch::Approx(1000.0));
+    REQUIRE(timing.frame(240) == 1500);
+    REQUIRE(timing.frame(1) == 4);
+}
+
+TEST_CASE("malformed files are rejected", "[midi|smf]")
+{
+    bytes riff{'R', 'I', 'F', 'F'};
+    REQUIRE_THROWS_AS(bit::midi::smf{riff}, std::runtime_error);
+
+    auto truncated = file(0, 96, {bytes{0x00, 0x90, 60, 100}});
+    truncated.resize(truncated.size() - 1);
+    REQUIRE_THROWS_AS(bit::midi::smf{truncated}, std::runtime_error);
+
+    auto two = file(2, 96, {end_of_track});
+    REQUIRE_THROWS_AS(bit::midi::smf{two}, std::runtime_error);
+    auto smpte = file(0, 0xe728, {end_of_track});
+    REQUIRE_THROWS_AS(bit::midi::smf{smpte}, std::runtime_error);
+
+    // tracks after the first are only decoded while iterating
+    auto statusless = file(1, 96, {end_of_track, bytes{0x00, 60, 100}});
+    bit::midi::smf song{statusless};
+    REQUIRE_THROWS_AS(all_events(song), std::runtime_error);
+}
+
+TEST_CASE("files are read through a memory map", "[midi|smf]")
+{
+    bytes track{0x00, 0x90, 60, 100, 0x83, 0x60, 0x80, 60, 0};
+    track.insert(track.end(), end_of_track.begin(), end_of_track.end());
+    auto encoded = file(0, 480, {track});
+    auto path =
+        std::filesystem::temp_directory_path() / "bitcrackle_smf_test.mid";
+    {
+        std::ofstream out{path, std::ios::binary};
+        out.write(reinterpret_cast<const char*>(encoded.data()),
+                  static_cast<std::streamsize>(encoded.size()));
+    }
+
+    {
+        bit::midi::smf song{path};
+        auto events = all_events(song);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[1].tick == 480);
+        REQUIRE(events[1].is_note_off());
+    }
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(bit::midi::smf{path}, std::runtime_error);
+}
+
+TEST_CASE("merged iteration", "[.benchmark][midi|smf]")
+{
+    // 16 tracks of 10000 notes each, staggered so that the merge interleaves
+    std::vector<bytes> tracks(16);
+    for (size_t t = 0; t < tracks.size(); ++t)
+    {
+        auto& track = tracks[t];
+        append(track, {static_cast<uint8_t>(t), 0x90});
+        for (uint8_t n = 0; n < 100; ++n)
+        {
+            for (size_t i = 0; i < 100; ++i)
+            {
+                append(track, {n, 100, 0x81, 0x00, n, 0, 0x10});
+            }
+        }
+        append(track, {60, 0});
+        track.insert(track.end(), end_of_track.begin(), end_of_track.end());
+    }
+    auto encoded = file(1, 480, {});
+    for (const auto& track : tracks)
+    {
+        auto chunked = chunk("MTrk", track);
+        encoded.insert(encoded.end(), chunked.begin(), chunked.end());
+    }
+    encoded[11] = static_cast<uint8_t>(tracks.size());
+    bit::midi::smf song{encoded};
+
+    BENCHMARK("16 tracks, 320000 events")
+    {
+        uint64_t sum = 0;
+        for (const auto& each : song.events())
+        {
+            sum += each.tick + each.data1;
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,430 @@
+#include <audio_engine/graph.h>
+#include <audio_engine/graph_executor.h>
+#include <audio_engine/patch_bank.h>
+#include <audio_engine/synth.h>
+#include <audio_engine/telemetry.h>
+#include <midi/smf.h>
+#include <wave/writer.hpp>
+
+#include "dsp/requantize.h"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+using clock       = std::chrono::steady_clock;
+using output_type = bit::qs<0, 15>;
+
+constexpr std::string_view usage =
+    "usage: bitcrackle-render input.mid output.wav [options]\n"
+    "\n"
+    "  --rate HZ          sampling frequency, 48000\n"
+    "  --block FRAMES     largest rendered block, 256\n"
+    "  --voices COUNT     polyphony, 16\n"
+    "  --threads COUNT    graph workers besides the main thread, 0\n"
+    "  --shape NAME       saw, pulse or triangle\n"
+    "  --attack SECONDS   envelope times, 0.005 0.2 and 0.3\n"
+    "  --decay SECONDS\n"
+    "  --release SECONDS\n"
+    "  --sustain LEVEL    0 to 1, 0.6\n"
+    "  --cutoff HZ        low pass, 6000\n"
+    "  --resonance Q      0.707\n"
+    "  --bits COUNT       kept by the crusher, 16\n"
+    "  --hold SAMPLES     held by the crusher, 1\n"
+    "  --gain LEVEL       of a voice at full velocity, 0.25\n"
+    "  --bank FILE        patch bank to play instead of the options above,\n"
+    "                     its first patch, then those program changes pick\n";
+
+struct options
+{
+    std::filesystem::path input;
+    std::filesystem::path output;
+    std::filesystem::path bank;
+    bit::patch sound;
+    uint32_t rate  = 48000;
+    size_t block   = 256;
+    size_t voices  = 16;
+    size_t threads = 0;
+};
+
+template <typename T>
+T parse_number(std::string_view name, std::string_view text)
+{
+    T value{};
+    auto [end, error] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} or end != text.data() + text.size())
+    {
+        throw std::runtime_error{
+            fmt::format("Invalid value '{}' of {}", text, name)};
+    }
+    return value;
+}
+
+bit::dsp::waveform parse_shape(std::string_view text)
+{
+    if (text == "saw")
+    {
+        return bit::dsp::waveform::saw;
+    }
+    if (text == "pulse")
+    {
+        return bit::dsp::waveform::pulse;
+    }
+    if (text == "triangle")
+    {
+        return bit::dsp::waveform::triangle;
+    }
+    throw std::runtime_error{fmt::format("Unknown shape '{}'", text)};
+}
+
+options parse_options(std::span<char*> arguments)
+{
+    options parsed;
+    std::vector<std::string_view> positional;
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+        std::string_view name = arguments[i];
+        if (not name.starts_with("--"))
+        {
+            positional.push_back(name);
+            continue;
+        }
+        if (i + 1 == arguments.size())
+        {
+            throw std::runtime_error{fmt::format("Missing value of {}", name)};
+        }
+        std::string_view value = arguments[++i];
+        auto& sound            = parsed.sound;
+        if (name == "--rate")
+        {
+            parsed.rate = parse_number<uint32_t>(name, value);
+        }
+        else if (name == "--block")
+        {
+            parsed.block = parse_number<size_t>(name, value);
+        }
+        else if (name == "--voices")
+        {
+            parsed.voices = parse_number<size_t>(name, value);
+        }
+        else if (name == "--threads")
+        {
+            parsed.threads = parse_number<size_t>(name, value);
+        }
+        else if (name == "--shape")
+        {
+            sound.shape = parse_shape(value);
+        }
+        else if (name == "--attack")
+        {
+            sound.attack = parse_number<double>(name, value);
+        }
+        else if (name == "--decay")
+        {
+            sound.decay = parse_number<double>(name, value);
+        }
+        else if (name == "--sustain")
+        {
+            sound.sustain = parse_number<double>(name, value);
+        }
+        else if (name == "--release")
+        {
+            sound.release = parse_number<double>(name, value);
+        }
+        else if (name == "--cutoff")
+        {
+            sound.cutoff = parse_number<double>(name, value);
+        }
+        else if (name == "--resonance")
+        {
+            sound.resonance = parse_number<double>(name, value);
+        }
+        else if (name == "--bits")
+        {
+            sound.depth = parse_number<size_t>(name, value);
+        }
+        else if (name == "--hold")
+        {
+            sound.hold = parse_number<size_t>(name, value);
+        }
+        else if (name == "--gain")
+        {
+            sound.gain = parse_number<double>(name, value);
+        }
+        else if (name == "--bank")
+        {
+            parsed.bank = value;
+        }
+        else
+        {
+            throw std::runtime_error{fmt::format("Unknown option {}", name)};
+        }
+    }
+    if (positional.size() != 2)
+    {
+        throw std::runtime_error{"Expected an input and an output file"};
+    }
+    if (parsed.rate == 0 or parsed.block == 0 or parsed.voices == 0)
+    {
+        throw std::runtime_error{"Rate, block and voices must be positive"};
+    }
+    parsed.input  = positional[0];
+    parsed.output = positional[1];
+    return parsed;
+}
+
+enum class stage : size_t
+{
+    midi,
+    voices,
+    mix,
+    requantize,
+    write,
+};
+
+constexpr std::array<std::string_view, 5> stage_names{
+    "midi", "voices", "mix", "requantize", "write"};
+
+// wall time spent in every stage, summed over the blocks
+class stage_timer
+{
+    std::array<clock::duration, stage_names.size()> _spent{};
+    clock::time_point _start = clock::now();
+
+  public:
+    // charges the time since the previous lap to the stage
+    void lap(stage finished) noexcept
+    {
+        auto now = clock::now();
+        _spent[static_cast<size_t>(finished)] += now - _start;
+        _start = now;
+    }
+
+    [[nodiscard]] double seconds(stage of) const noexcept
+    {
+        auto spent = _spent[static_cast<size_t>(of)];
+        return std::chrono::duration<double>(spent).count();
+    }
+};
+
+class renderer
+{
+    bit::synth _synth;
+    std::unique_ptr<bit::graph_schedule> _schedule;
+    std::unique_ptr<bit::graph_executor> _executor;
+    std::vector<bit::synth::bus_type> _left;
+    std::vector<bit::synth::bus_type> _right;
+    std::vector<output_type> _quantized;
+    std::vector<int16_t> _interleaved;
+    bit::dsp::requantizer<bit::synth::bus_type, output_type> _left_quantizer{
+        1};
+    bit::dsp::requantizer<bit::synth::bus_type, output_type> _right_quantizer{
+        2};
+    bit::wave::writer _writer;
+    double _rate;
+
+  public:
+    stage_timer timer;
+    bit::engine_telemetry telemetry;
+    uint64_t frames = 0;
+
+    explicit renderer(const options& settings)
+        : _synth{settings.sound,
+                 static_cast<double>(settings.rate),
+                 settings.voices,
+                 settings.block},
+          _left(settings.block), _right(settings.block),
+          _quantized(settings.block), _interleaved(2 * settings.block),
+          _writer{bit::wave::header{2, settings.rate, 16}, settings.output},
+          _rate{static_cast<double>(settings.rate)}
+    {
+        if (settings.threads > 0)
+        {
+            // one node per voice, they don't depend on each other
+            bit::processing_graph graph;
+            for (size_t v = 0; v < _synth.voices(); ++v)
+            {
+                graph.add([this, v](size_t count) {
+                    _synth.render_voice(v, count);
+                });
+            }
+            _schedule = graph.compile();
+            _executor = std::make_unique<bit::graph_executor>(settings.threads);
+        }
+    }
+
+    [[nodiscard]] bit::synth& synth() noexcept
+    {
+        return _synth;
+    }
+
+    void render(size_t count)
+    {
+        // as if the block had to be ready in real time
+        auto deadline = std::chrono::nanoseconds{
+            std::llround(static_cast<double>(count) * 1e9 / _rate)};
+        auto block = telemetry.time_block(deadline);
+        telemetry.record_voices(_synth.active_voices());
+        if (_executor)
+        {
+            _synth.prepare(count);
+            _executor->run(*_schedule, count);
+        }
+        else
+        {
+            _synth.render(count);
+        }
+        timer.lap(stage::voices);
+
+        auto left  = std::span{_left}.first(count);
+        auto right = std::span{_right}.first(count);
+        _synth.mix(left, right);
+        timer.lap(stage::mix);
+
+        auto quantized = std::span{_quantized}.first(count);
+        _left_quantizer.process(left, quantized);
+        for (size_t i = 0; i < count; ++i)
+        {
+            _interleaved[2 * i] = quantized[i].raw();
+        }
+        _right_quantizer.process(right, quantized);
+        for (size_t i = 0; i < count; ++i)
+        {
+            _interleaved[2 * i + 1] = quantized[i].raw();
+        }
+        timer.lap(stage::requantize);
+
+        _writer.write(std::span{_interleaved}.first(2 * count));
+        timer.lap(stage::write);
+        frames += count;
+    }
+};
+
+void apply(bit::synth& synth,
+           const bit::patch_bank* bank,
+           const bit::midi::event& event)
+{
+    if (event.is_note_on())
+    {
+        synth.note_on(event.data1, event.data2);
+    }
+    else if (event.is_note_off())
+    {
+        synth.note_off(event.data1);
+    }
+    // all sound off and all notes off
+    else if (event.type() == bit::midi::message::control_change and
+             (event.data1 == 120 or event.data1 == 123))
+    {
+        synth.all_notes_off();
+    }
+    else if (event.type() == bit::midi::message::program_change and bank and
+             event.data1 < bank->patches().size())
+    {
+        synth.set_program(bank->patch(event.data1));
+    }
+}
+
+int run(const options& settings)
+{
+    auto wall_start = clock::now();
+    bit::midi::smf song{settings.input};
+    std::optional<bit::patch_bank> bank;
+    renderer render{settings};
+    if (not settings.bank.empty())
+    {
+        bank.emplace(settings.bank);
+        if (not bank->patches().empty())
+        {
+            render.synth().set_program(bank->patch(0));
+        }
+    }
+    render.timer.lap(stage::midi);
+
+    // all channels play the one patch, a program change on any switches it
+    auto timing  = song.timing(settings.rate);
+    size_t count = 0;
+    for (const auto& event : song.events())
+    {
+        auto due = timing.frame(event.tick);
+        if (render.frames < due)
+        {
+            render.timer.lap(stage::midi);
+            while (render.frames < due)
+            {
+                render.render(static_cast<size_t>(
+                    std::min<uint64_t>(settings.block, due - render.frames)));
+            }
+        }
+        apply(render.synth(), bank ? &*bank : nullptr, event);
+        ++count;
+    }
+    render.timer.lap(stage::midi);
+    // the release tails
+    render.synth().all_notes_off();
+    while (render.synth().active_voices() > 0)
+    {
+        render.render(settings.block);
+    }
+
+    auto wall  = std::chrono::duration<double>(clock::now() - wall_start);
+    auto audio = static_cast<double>(render.frames) / settings.rate;
+    fmt::print("{}: {} events, {} tracks, at most {} voices\n",
+               settings.input.string(),
+               count,
+               song.tracks(),
+               render.telemetry.snapshot().max_voices);
+    fmt::print("rendered {:.3f} s of audio in {:.3f} s, {:.1f}x real time\n",
+               audio,
+               wall.count(),
+               audio / wall.count());
+    for (size_t s = 0; s < stage_names.size(); ++s)
+    {
+        auto spent = render.timer.seconds(static_cast<stage>(s));
+        fmt::print("  {:<12}{:10.3f} ms {:6.1f} %\n",
+                   stage_names[s],
+                   spent * 1e3,
+                   100 * spent / wall.count());
+    }
+    fmt::print("{}\n", bit::to_json(render.telemetry.snapshot()));
+    return 0;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::optional<options> settings;
+    try
+    {
+        settings = parse_options(std::span{argv + 1, argv + argc});
+    }
+    catch (const std::exception& error)
+    {
+        fmt::print(stderr, "{}\n\n{}", error.what(), usage);
+        return 2;
+    }
+    try
+    {
+        return run(*settings);
+    }
+    catch (const std::exception& error)
+    {
+        fmt::print(stderr, "{}\n", error.what());
+        return 1;
+    }
+}
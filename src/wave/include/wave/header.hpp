@@ -51,8 +51,10 @@ struct header
         : channels(channels), sample_rate(sample_rate),
           bits_per_sample(bits_per_sample)
     {
-        bytes_per_sample = static_cast<uint16_t>(bits_per_sample / 8);
-        bytes_per_second = sample_rate * channels * bytes_per_sample;
+        // of one frame, all channels
+        bytes_per_sample =
+            static_cast<uint16_t>(channels * bits_per_sample / 8);
+        bytes_per_second = sample_rate * bytes_per_sample;
     }
 };
 static_assert(std::is_trivially_copyable_v<header>);
@@ -55,6 +55,6 @@ size_t reader::bytes_left() const
 
 size_t reader::frames_left() const
 {
-    return bytes_left() / (_header.channels * (_header.bytes_per_sample));
+    return bytes_left() / _header.bytes_per_sample;
 }
 } // namespace bit::wave